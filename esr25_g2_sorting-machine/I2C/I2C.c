@@ -11,135 +11,452 @@
 
 #include "I2C.h"
 #include "msp430fr2355.h"
+#include "timer/timer.h"
+#include "clock/clock.h"
+#include "power/power.h"
+#include "ramfunc/ramfunc.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
-/** Pointer auf das aktuell zu übertragende Byte. */
-static char *packet;
+/* ========================================================================== */
+/* eUSCI_B Registerzugriff über die Basisadresse                              */
+/* ========================================================================== */
+
+#define UCB_CTLW0   0x00 /**< Offset UCBxCTLW0 */
+#define UCB_CTLW1   0x02 /**< Offset UCBxCTLW1 */
+#define UCB_BRW     0x06 /**< Offset UCBxBRW */
+#define UCB_TBCNT   0x0A /**< Offset UCBxTBCNT */
+#define UCB_RXBUF   0x0C /**< Offset UCBxRXBUF */
+#define UCB_TXBUF   0x0E /**< Offset UCBxTXBUF */
+#define UCB_I2CSA   0x20 /**< Offset UCBxI2CSA */
+#define UCB_IE      0x2A /**< Offset UCBxIE */
+#define UCB_IFG     0x2C /**< Offset UCBxIFG */
+#define UCB_IV      0x2E /**< Offset UCBxIV */
+
+/** @brief 16-Bit Register eines eUSCI_B Moduls. */
+#define UCB_REG(bus, ofs) (*(volatile uint16_t *)((uintptr_t)(bus)->base + (ofs)))
+
+/** @brief Aktivierte Interrupts: RX, TX, STOP, NACK, Clock-Low-Timeout. */
+#define UCB_IE_MASK (UCRXIE0 | UCTXIE0 | UCSTPIE | UCNACKIE | UCCLTOIE)
 
-/** Index des nächsten zu übertragenden Bytes. */
-static unsigned int data_cnt;
+I2C_bus_t I2C_bus0 = {
+    0x0540, &P1IN, &P1OUT, &P1DIR, &P1SEL0, &P1SEL1, BIT2, BIT3
+};
 
-/** Anzahl der Bytes in @ref packet. */
-static unsigned int packet_length;
+I2C_bus_t I2C_bus1 = {
+    0x0580, &P4IN, &P4OUT, &P4DIR, &P4SEL0, &P4SEL1, BIT6, BIT7
+};
+
+/** Alle Busse, z.B. für die Anpassung an einen Taktwechsel. */
+static I2C_bus_t *const buses[] = { &I2C_bus0, &I2C_bus1 };
+
+/**
+ * @brief Liefert den Zählereintrag eines Slaves und legt ihn bei Bedarf an.
+ *
+ * Sind alle Einträge belegt, wird der letzte Eintrag gemeinsam genutzt.
+ */
+static I2C_dev_stats_t *stats_slot(I2C_bus_t *bus, uint8_t slave_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < I2C_MAX_DEVICES - 1; i++)
+    {
+        if (bus->stats[i].addr == slave_addr || bus->stats[i].addr == 0)
+            break;
+    }
+    bus->stats[i].addr = slave_addr;
+    return &bus->stats[i];
+}
+
+/**
+ * @brief Schließt das Fenster der Busauslastung ab, wenn es abgelaufen ist.
+ */
+static void close_window(I2C_bus_t *bus, uint32_t now)
+{
+    uint32_t elapsed = now - bus->window_start;
+
+    if (elapsed < timer_ms_to_stamp(I2C_UTIL_WINDOW_MS))
+        return;
+
+    bus->util = (uint8_t)(((uint32_t)bus->window_busy * 100) / elapsed);
+    bus->window_start = now;
+    bus->window_busy = 0;
+}
+
+/**
+ * @brief Verbucht eine Übertragung beim Slave und in der Busauslastung.
+ *
+ * @param[in] start Zeitstempel vor dem START.
+ */
+static void account(I2C_bus_t *bus, uint8_t slave_addr, uint8_t length, uint16_t start)
+{
+    I2C_dev_stats_t *stats = stats_slot(bus, slave_addr);
+    uint16_t now = timer_stamp();
+    uint16_t busy = now - start;
+
+    stats->transfers++;
+    stats->bytes += length;
+    stats->busy += busy;
+    bus->busy += busy;
+    bus->window_busy += busy;
+
+    close_window(bus, timer_stamp32());
+}
+
+/**
+ * @brief Wartet eine halbe SCL-Periode der Bus-Freigabe (≈ 10 µs).
+ *
+ * Eine Schleifeniteration benötigt etwa 5 CPU-Takte.
+ */
+static void clear_half_period(void)
+{
+    uint16_t n = (uint16_t)(clock_mclk_hz() / 500000UL);
+
+    while (n--)
+        __delay_cycles(1);
+}
+
+/**
+ * @brief Wartet im LPM3 auf das Ende der laufenden Transaktion.
+ *
+ * Interrupts werden vor der Prüfung gesperrt und erst mit dem Eintritt in
+ * den LPM3 wieder freigegeben, damit kein Wecksignal verloren geht.
+ */
+static I2C_status_t wait_done(I2C_bus_t *bus)
+{
+    timer_timeout_start(I2C_TIMEOUT_MS);
+
+    __disable_interrupt();
+    while (!bus->done && !timer_timeout_expired())
+    {
+        power_sleep(POWER_LPM3); // Warten auf STOP → ISR weckt uns auf
+    }
+    __enable_interrupt();
+
+    if (!bus->done)
+    {
+        bus->result = I2C_ERR_TIMEOUT;
+    }
+    else if (bus->result == I2C_ERR_NACK)
+    {
+        // STOP nach NACK abwarten, damit dessen STPIFG nicht die nächste
+        // Transaktion beendet
+        while ((UCB_REG(bus, UCB_CTLW0) & UCTXSTP) && !timer_timeout_expired())
+            ;
+        UCB_REG(bus, UCB_IFG) &= ~UCSTPIFG;
+    }
+
+    timer_timeout_stop();
+    return bus->result;
+}
+
+/**
+ * @brief Führt eine einzelne Transaktion ohne Wiederholung aus.
+ */
+static I2C_status_t transfer(I2C_bus_t *bus, uint8_t slave_addr, char data[],
+                             uint8_t length, bool tx)
+{
+    UCB_REG(bus, UCB_I2CSA) = slave_addr;
+    bus->packet = data;
+    bus->packet_length = length;
+    bus->data_cnt = 0;
+
+    if (tx)
+        UCB_REG(bus, UCB_CTLW0) |= UCTR;  // Master-Transmit-Modus
+    else
+        UCB_REG(bus, UCB_CTLW0) &= ~UCTR; // Master-Receive-Modus
+    UCB_REG(bus, UCB_TBCNT) = length;
+
+    bus->done = false;
+    bus->result = I2C_OK;
+
+    // START generieren, dann schlafen bis STOP
+    UCB_REG(bus, UCB_CTLW0) |= UCTXSTT;
+
+    return wait_done(bus);
+}
+
+/**
+ * @brief Führt eine Übertragung aus und verbucht sie (siehe account()).
+ */
+static I2C_status_t counted_transfer(I2C_bus_t *bus, uint8_t slave_addr, char data[],
+                                     uint8_t length, bool tx)
+{
+    uint16_t start = timer_stamp();
+    I2C_status_t status = transfer(bus, slave_addr, data, length, tx);
+
+    account(bus, slave_addr, length, start);
+    return status;
+}
 
-/** Speicher für das zuletzt vom ISR empfangene Byte. */
-static char data_in;
+/**
+ * @brief Zählt einen Fehler und gibt den Bus nach einem Timeout frei.
+ */
+static void handle_error(I2C_bus_t *bus, uint8_t slave_addr, I2C_status_t status)
+{
+    I2C_dev_stats_t *stats = stats_slot(bus, slave_addr);
 
-static volatile bool i2c_done = false;
+    if (status == I2C_ERR_NACK)
+    {
+        stats->nack++;
+    }
+    else
+    {
+        stats->timeout++;
+        stats->bus_clear++;
+        I2C_bus_clear(bus);
+    }
+}
 
-void I2C_init(void)
+void I2C_init(I2C_bus_t *bus)
 {
     // USCI in Reset setzen um Konfiguration zu ermöglichen
-    UCB0CTLW0 |= UCSWRST;
+    UCB_REG(bus, UCB_CTLW0) |= UCSWRST;
 
-    // SMCLK wählen und durch 20 teilen → 50 kHz SCL
-    UCB0CTLW0 |= UCSSEL_3;
-    UCB0BRW = 20;
+    // SMCLK wählen und auf 50 kHz SCL teilen (1 MHz / 20)
+    UCB_REG(bus, UCB_CTLW0) |= UCSSEL_3;
+    UCB_REG(bus, UCB_BRW) = (uint16_t)(clock_smclk_hz() / I2C_SCL_HZ);
 
     // I²C Master, 7-Bit Adressierung
-    UCB0CTLW0 |= UCMODE_3 | UCMST;
+    UCB_REG(bus, UCB_CTLW0) |= UCMODE_3 | UCMST;
 
-    // Automatischer STOP nach Byte-Zähler (UCB0TBCNT) erreicht Null
-    UCB0CTLW1 |= UCASTP_2;
+    // Automatischer STOP nach Byte-Zähler (UCBxTBCNT) erreicht Null,
+    // Clock-Low-Timeout nach ≈ 28 ms
+    UCB_REG(bus, UCB_CTLW1) |= UCASTP_2 | UCCLTO_1;
 
-    // Port-Mapping: P1.2 = SDA, P1.3 = SCL
-    P1SEL1 &= ~(BIT2 | BIT3);
-    P1SEL0 |= BIT2 | BIT3;
+    // Port-Mapping: SDA und SCL auf I²C-Funktion
+    *bus->port_sel1 &= ~(bus->sda | bus->scl);
+    *bus->port_sel0 |= bus->sda | bus->scl;
 
     // Modul aktivieren
-    UCB0CTLW0 &= ~UCSWRST;
+    UCB_REG(bus, UCB_CTLW0) &= ~UCSWRST;
+
+    // Interrupts: RX, TX, STOP, NACK, Clock-Low-Timeout
+    UCB_REG(bus, UCB_IE) |= UCB_IE_MASK;
 
-    // Interrupts: RX, TX, STOP, NACK
-    UCB0IE |= UCRXIE0 | UCTXIE0 | UCSTPIE | UCNACKIE;
+    bus->initialized = true;
+    clock_register_listener(I2C_set_clock);
 }
 
-void I2C_write(uint8_t slave_addr, char data[], uint8_t length)
+void I2C_set_clock(uint32_t smclk_hz)
 {
-    UCB0I2CSA = slave_addr;
-    packet = data;
-    packet_length = length;
-    data_cnt = 0;
+    uint8_t i;
 
-    // Master-Transmit-Modus
-    UCB0CTLW0 |= UCTR;
-    UCB0TBCNT = length;
+    for (i = 0; i < sizeof(buses) / sizeof(buses[0]); i++)
+    {
+        if (!buses[i]->initialized)
+            continue;
 
-    // START generieren, dann schlafen bis STOP
-    UCB0CTLW0 |= UCTXSTT;
-    
-    i2c_done = false;
-    while (!i2c_done){
-        __bis_SR_register(LPM3_bits | GIE); // Warten auf STOP → ISR weckt uns auf
+        // Teiler kann nur im Reset geändert werden, Reset löscht UCBxIE
+        UCB_REG(buses[i], UCB_CTLW0) |= UCSWRST;
+        UCB_REG(buses[i], UCB_BRW) = (uint16_t)(smclk_hz / I2C_SCL_HZ);
+        UCB_REG(buses[i], UCB_CTLW0) &= ~UCSWRST;
+        UCB_REG(buses[i], UCB_IE) |= UCB_IE_MASK;
     }
 }
 
-char I2C_read_reg(uint8_t slave_addr, uint8_t reg_addr)
+I2C_status_t I2C_write(I2C_bus_t *bus, uint8_t slave_addr, char data[], uint8_t length)
 {
+    I2C_status_t status = I2C_OK;
+    uint8_t attempt;
+
+    for (attempt = 0; attempt <= I2C_RETRIES; attempt++)
+    {
+        status = counted_transfer(bus, slave_addr, data, length, true);
+        if (status == I2C_OK)
+            return I2C_OK;
+
+        handle_error(bus, slave_addr, status);
+    }
+
+    stats_slot(bus, slave_addr)->failed++;
+    return status;
+}
+
+I2C_status_t I2C_read_reg(I2C_bus_t *bus, uint8_t slave_addr, uint8_t reg_addr, char *value)
+{
+    I2C_status_t status = I2C_OK;
+    uint8_t attempt;
+
     // Registeradresse zuerst senden
     char addr_buf[1] = {reg_addr};
-    I2C_write(slave_addr, addr_buf, 1);
 
-    // In Empfangsmodus wechseln und 1 Byte anfordern
-    UCB0CTLW0 &= ~UCTR;
-    UCB0TBCNT = 1;
+    for (attempt = 0; attempt <= I2C_RETRIES; attempt++)
+    {
+        status = counted_transfer(bus, slave_addr, addr_buf, 1, true);
+
+        // In Empfangsmodus wechseln und 1 Byte anfordern (Repeated START)
+        if (status == I2C_OK)
+            status = counted_transfer(bus, slave_addr, NULL, 1, false);
 
-    UCB0CTLW0 |= UCTXSTT; // Repeated START
-        
-    i2c_done = false;
-    while (!i2c_done){
-        __bis_SR_register(LPM3_bits | GIE);  // Warten auf STOP → ISR weckt uns auf
-    }           
+        if (status == I2C_OK)
+        {
+            *value = bus->data_in;
+            return I2C_OK;
+        }
 
-    return data_in;
+        handle_error(bus, slave_addr, status);
+    }
+
+    stats_slot(bus, slave_addr)->failed++;
+    *value = 0;
+    return status;
+}
+
+bool I2C_probe(I2C_bus_t *bus, uint8_t slave_addr)
+{
+    I2C_status_t status = transfer(bus, slave_addr, NULL, 1, false);
+
+    // Ohne Pull-ups oder bei blockiertem Bus läuft der Timeout ab
+    if (status == I2C_ERR_TIMEOUT)
+        I2C_bus_clear(bus);
+
+    return status == I2C_OK;
+}
+
+void I2C_bus_clear(I2C_bus_t *bus)
+{
+    uint8_t i;
+
+    // USCI anhalten und Pins als GPIO nutzen; High = Eingang (Pull-up),
+    // Low = Ausgang auf 0 (Open-Drain Nachbildung)
+    UCB_REG(bus, UCB_CTLW0) |= UCSWRST;
+    *bus->port_out &= ~(bus->sda | bus->scl);
+    *bus->port_dir &= ~(bus->sda | bus->scl);
+    *bus->port_sel0 &= ~(bus->sda | bus->scl);
+
+    // Bis zu 9 Takte, bis der Slave SDA freigibt
+    for (i = 0; i < 9 && !(*bus->port_in & bus->sda); i++)
+    {
+        *bus->port_dir |= bus->scl;             // SCL low
+        clear_half_period();
+        *bus->port_dir &= ~bus->scl;            // SCL high
+        clear_half_period();
+    }
+
+    // STOP: SDA low → high während SCL high
+    *bus->port_dir |= bus->scl;                 // SCL low
+    *bus->port_dir |= bus->sda;                 // SDA low
+    clear_half_period();
+    *bus->port_dir &= ~bus->scl;                // SCL high
+    clear_half_period();
+    *bus->port_dir &= ~bus->sda;                // SDA high → STOP
+    clear_half_period();
+
+    I2C_init(bus);
+}
+
+const I2C_dev_stats_t *I2C_get_stats(const I2C_bus_t *bus, uint8_t slave_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < I2C_MAX_DEVICES; i++)
+    {
+        if (bus->stats[i].addr == slave_addr)
+            return &bus->stats[i];
+    }
+    return NULL;
+}
+
+uint8_t I2C_utilization(I2C_bus_t *bus)
+{
+    close_window(bus, timer_stamp32());
+    return bus->util;
+}
+
+void I2C_hold(I2C_bus_t *bus)
+{
+    if (bus->holds < 0xFF)
+        bus->holds++;
+}
+
+void I2C_release(I2C_bus_t *bus)
+{
+    if (bus->holds > 0)
+        bus->holds--;
+}
+
+bool I2C_held(const I2C_bus_t *bus)
+{
+    return bus->holds != 0;
 }
 
 /* ========================================================================== */
-/* Interrupt Service Routine                                                  */
+/* Interrupt Service Routinen                                                 */
 /* ========================================================================== */
 
 /**
- * @brief Vereinheitlichte ISR für alle USCI_B0 I²C-Ereignisse.
+ * @brief Gemeinsame Behandlung aller eUSCI_B I²C-Ereignisse eines Busses.
  *
- * Nur vier Interrupt-Ursachen werden derzeit behandelt:
- *   - UCNACKIFG : Kennzeichnet fehlendes ACK (nur Debug-Hook)
+ * Folgende Interrupt-Ursachen werden behandelt:
+ *   - UCNACKIFG : Fehlendes ACK → STOP senden, LPM3 verlassen
+ *   - UCCLTOIFG : SCL zu lange low → Timeout melden, LPM3 verlassen
  *   - UCSTPIFG  : STOP erkannt → LPM3 verlassen
  *   - UCRXIFG0  : Ein Byte empfangen
  *   - UCTXIFG0  : Sendepuffer bereit für nächstes Byte
  *
- * Alle anderen Ursachen fallen durch zum default.
+ * Alle anderen Ursachen fallen durch zum default. Liegt selbst im RAM, da
+ * ohne Optimierung nicht in die beiden ISRs eingebettet wird.
+ *
+ * @return true wenn die CPU beim Verlassen der ISR geweckt werden soll.
  */
-#pragma vector = EUSCI_B0_VECTOR
-__interrupt void EUSCI_B0_I2C_ISR(void)
+static RAMFUNC bool bus_isr(I2C_bus_t *bus)
 {
-    switch (__even_in_range(UCB0IV, USCI_I2C_UCBIT9IFG)) {
+    switch (__even_in_range(UCB_REG(bus, UCB_IV), USCI_I2C_UCBIT9IFG)) {
         case USCI_I2C_UCNACKIFG:
-            // Derzeit nur für Debug
-            i2c_done = true;
-            __bic_SR_register_on_exit(LPM3_bits);
-            __no_operation();
-            break;
+            // Slave antwortet nicht → Übertragung mit STOP abbrechen
+            UCB_REG(bus, UCB_CTLW0) |= UCTXSTP;
+            bus->result = I2C_ERR_NACK;
+            bus->done = true;
+            return true;
 
         case USCI_I2C_UCSTPIFG:
             // STOP → CPU aufwecken (LPM3 verlassen)
-            i2c_done = true;
-            __bic_SR_register_on_exit(LPM3_bits);
-            break;
+            bus->done = true;
+            return true;
 
         case USCI_I2C_UCRXIFG0:
             // Empfangenes Byte speichern
-            data_in = UCB0RXBUF;
+            bus->data_in = UCB_REG(bus, UCB_RXBUF);
             break;
 
         case USCI_I2C_UCTXIFG0:
             // Nächstes Datenbyte senden oder Übertragung beenden
-            UCB0TXBUF = packet[data_cnt++];
-            if (data_cnt >= packet_length)
-                data_cnt = 0; // Für nächste Transaktion zurücksetzen
+            UCB_REG(bus, UCB_TXBUF) = bus->packet[bus->data_cnt++];
+            if (bus->data_cnt >= bus->packet_length)
+                bus->data_cnt = 0; // Für nächste Transaktion zurücksetzen
             break;
 
+        case USCI_I2C_UCCLTOIFG:
+            // SCL wird von einem Slave festgehalten
+            bus->result = I2C_ERR_TIMEOUT;
+            bus->done = true;
+            return true;
+
         default:
             // Unbehandelter Vektor – nichts zu tun
             break;
     }
+    return false;
+}
+
+/**
+ * @brief ISR des eUSCI_B0 (I2C_bus0).
+ */
+#pragma vector = EUSCI_B0_VECTOR
+RAMFUNC __interrupt void EUSCI_B0_I2C_ISR(void)
+{
+    if (bus_isr(&I2C_bus0))
+        __bic_SR_register_on_exit(LPM3_bits);
+}
+
+/**
+ * @brief ISR des eUSCI_B1 (I2C_bus1).
+ */
+#pragma vector = EUSCI_B1_VECTOR
+RAMFUNC __interrupt void EUSCI_B1_I2C_ISR(void)
+{
+    if (bus_isr(&I2C_bus1))
+        __bic_SR_register_on_exit(LPM3_bits);
 }
@@ -8,42 +8,174 @@
  *
  * @brief     Minimaler Master-Modus I²C-Treiber für den MSP430FR2355.
  *
- * Das Modul bietet drei blockierende Hilfsfunktionen:
- *   - I2C_init()         – USCI B0 für 50 kHz I²C Master konfigurieren
+ * Jeder I²C-Bus wird durch eine eigene Instanz (I2C_bus_t) beschrieben,
+ * die Register, Pins und den Zustand der laufenden Transaktion enthält:
+ *   - I2C_bus0 – eUSCI_B0, P1.2 (SDA) / P1.3 (SCL): PCA9685, LCD, TCS_sensor1
+ *   - I2C_bus1 – eUSCI_B1, P4.6 (SDA) / P4.7 (SCL): TCS_sensor0
+ *
+ * Das Modul bietet folgende blockierende Hilfsfunktionen:
+ *   - I2C_init()         – eUSCI_B für 50 kHz I²C Master konfigurieren
  *   - I2C_write()        – Beliebige Anzahl von Bytes übertragen
  *   - I2C_read_reg()     – Ein einzelnes Byte-Register lesen
+ *   - I2C_probe()        – Prüfen, ob ein Slave antwortet
+ *   - I2C_bus_clear()    – Blockierten Bus per Software freigeben
+ *   - I2C_get_stats()    – Fehler- und Lastzähler eines Slaves abfragen
+ *   - I2C_utilization()  – Auslastung eines Busses abfragen
+ *   - I2C_hold() / I2C_release() / I2C_held() – Bus für zeitkritische
+ *     Abläufe vormerken, nachrangige Teilnehmer (LCD) warten
+ *
+ * Die Kommunikation wird im Hintergrund von der Interrupt-Service-Routine
+ * des jeweiligen eUSCI_B Moduls behandelt. Die Funktionen versetzen die CPU
+ * in LPM3 bis die entsprechende STOP-Bedingung generiert wurde.
+ *
+ * Fehlerbehandlung:
+ *   - NACK des Slaves beendet die Transaktion mit STOP
+ *   - Clock-Low-Timeout (UCCLTO) und ein Software-Timeout verhindern,
+ *     dass ein blockierter Bus die CPU dauerhaft anhält
+ *   - Nach einem Timeout wird der Bus mit 9 SCL-Pulsen und STOP freigegeben
+ *   - Jede Transaktion wird bis zu I2C_RETRIES mal wiederholt
  *
- * Die Kommunikation wird im Hintergrund von der EUSCI_B0 Interrupt-Service-
- * Routine behandelt. Die Funktionen versetzen die CPU
- * in LPM0 bis die entsprechende STOP-Bedingung generiert wurde.
+ * Lastmessung: Für jede Übertragung von I2C_write() und I2C_read_reg()
+ * werden je Slave Anzahl, Nutzdatenbytes und Belegungszeit (START bis
+ * STOP, Ticks von timer_stamp()) gezählt. Gemessen wird ausschließlich
+ * außerhalb der ISR. Aus der Belegungszeit je Bus ergibt sich die
+ * Auslastung über Fenster von I2C_UTIL_WINDOW_MS.
  *
- * @note Detzt voraus, dass SMCLK mit 1 MHz läuft. Vor Verwendung
- *       anderer Funktionen muss die init() Methode aufgerufen werden.
+ * @note Der Bitraten-Teiler wird aus der SMCLK des aktiven Taktprofils
+ *       berechnet und bei jedem Taktwechsel angepasst. Vor Verwendung
+ *       anderer Funktionen muss die init() Methode für jeden Bus
+ *       aufgerufen werden.
  */
 
 #ifndef I2C_I2C_H_
 #define I2C_I2C_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief SCL-Frequenz in Hz. */
+#define I2C_SCL_HZ        50000UL
+
+/** @brief Anzahl der Wiederholungen nach einer fehlgeschlagenen Transaktion. */
+#define I2C_RETRIES       2
+
+/** @brief Software-Timeout je Transaktion in ms. */
+#define I2C_TIMEOUT_MS    10
+
+/** @brief Anzahl der Slaves je Bus, für die Fehlerzähler geführt werden. */
+#define I2C_MAX_DEVICES   4
+
+/** @brief Fensterlänge der Busauslastung in ms. */
+#define I2C_UTIL_WINDOW_MS 1000
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Ergebnis einer I²C-Transaktion.
+ */
+typedef enum
+{
+    I2C_OK = 0,        /**< Transaktion erfolgreich */
+    I2C_ERR_NACK,      /**< Slave hat Adresse oder Daten nicht bestätigt */
+    I2C_ERR_TIMEOUT,   /**< Clock-Low- oder Software-Timeout */
+    I2C_ERR_ABSENT     /**< Slave hat beim Start nicht geantwortet, kein Busverkehr */
+} I2C_status_t;
+
+/**
+ * @brief Fehler- und Lastzähler eines Slaves.
+ */
+typedef struct
+{
+    uint8_t  addr;        /**< 7-Bit Slave-Adresse (0 = Eintrag frei) */
+    uint16_t nack;        /**< Anzahl NACKs */
+    uint16_t timeout;     /**< Anzahl Timeouts */
+    uint16_t bus_clear;   /**< Anzahl ausgelöster Bus-Freigaben */
+    uint16_t failed;      /**< Transaktionen, die auch nach allen Wiederholungen scheiterten */
+    uint32_t transfers;   /**< Übertragungen (START bis STOP) inkl. Wiederholungen */
+    uint32_t bytes;       /**< Übertragene Nutzdatenbytes */
+    uint32_t busy;        /**< Belegungszeit des Busses in Ticks von timer_stamp() */
+} I2C_dev_stats_t;
+
+/**
+ * @brief Instanz eines I²C-Busses.
+ *
+ * Die Hardwarebeschreibung ist fest, der übrige Inhalt wird vom Treiber
+ * und der ISR verwaltet.
+ */
+typedef struct
+{
+    /* Hardware */
+    uint16_t          base;      /**< Basisadresse des eUSCI_B Moduls */
+    volatile uint8_t *port_in;   /**< PxIN der SDA/SCL Pins */
+    volatile uint8_t *port_out;  /**< PxOUT der SDA/SCL Pins */
+    volatile uint8_t *port_dir;  /**< PxDIR der SDA/SCL Pins */
+    volatile uint8_t *port_sel0; /**< PxSEL0 der SDA/SCL Pins */
+    volatile uint8_t *port_sel1; /**< PxSEL1 der SDA/SCL Pins */
+    uint8_t           sda;       /**< Bitmaske des SDA Pins */
+    uint8_t           scl;       /**< Bitmaske des SCL Pins */
+
+    /* Laufende Transaktion */
+    char             *packet;         /**< Sendepuffer */
+    uint16_t          data_cnt;       /**< Index des nächsten Bytes */
+    uint16_t          packet_length;  /**< Anzahl der Bytes im Sendepuffer */
+    char              data_in;        /**< Zuletzt empfangenes Byte */
+    volatile bool     done;           /**< STOP, NACK oder Timeout erkannt */
+    volatile I2C_status_t result;     /**< Ergebnis, von der ISR gesetzt */
+
+    bool              initialized;    /**< I2C_init() wurde aufgerufen */
+    I2C_dev_stats_t   stats[I2C_MAX_DEVICES]; /**< Fehler- und Lastzähler je Slave */
+
+    /* Auslastung */
+    uint32_t          busy;           /**< Belegungszeit aller Slaves in Ticks */
+    uint32_t          window_start;   /**< Beginn des laufenden Fensters (timer_stamp32()) */
+    uint16_t          window_busy;    /**< Belegungszeit im laufenden Fenster */
+    uint8_t           util;           /**< Auslastung des letzten Fensters in % */
+
+    /* Vorrang */
+    uint8_t           holds;          /**< Laufende zeitkritische Abläufe (I2C_hold()) */
+} I2C_bus_t;
+
+/** @brief Bus an eUSCI_B0 (P1.2 SDA, P1.3 SCL). */
+extern I2C_bus_t I2C_bus0;
+
+/** @brief Bus an eUSCI_B1 (P4.6 SDA, P4.7 SCL). */
+extern I2C_bus_t I2C_bus1;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
 
 /**
- * @brief Initialisiert USCIB0 für 7-Bit I²C-Master-Betrieb.
+ * @brief Initialisiert einen eUSCI_B für 7-Bit I²C-Master-Betrieb.
  *
- * Diese Routine nimmt an, dass SMCLK bereits mit **1 MHz** läuft.
- * Mit dem auf 20 gesetzten Teiler beträgt die resultierende SCL-Frequenz
- * dann 50 kHz.
+ * Der Teiler wird aus der aktuellen SMCLK berechnet, bei 1 MHz beträgt
+ * er 20. Das Modul registriert sich für Taktwechsel beim clock Modul.
  *
- * Das wird USCIB0 konfiguriert für:
- *   - Taktquelle:  SMCLK (1 MHz erwartet)
- *   - Bitrate:     50 kHz (SMCLK / 20)
+ * Das wird der eUSCI_B konfiguriert für:
+ *   - Taktquelle:  SMCLK
+ *   - Bitrate:     50 kHz (SMCLK / I2C_SCL_HZ)
  *   - Automatische STOP-Generierung über Byte-Zähler
  *
- * Ports P1.2 (SDA) und P1.3 (SCL) werden auf ihre I²C-Funktion gemultiplext.
+ * Die SDA/SCL Pins des Busses werden auf ihre I²C-Funktion gemultiplext.
  *
- * Aktiviert das globale Interrupt-Flag, damit die ISR
- * I²C-Ereignisse bedienen kann.
+ * @param[in,out] bus Zu initialisierender Bus.
  */
-void I2C_init(void);
+void I2C_init(I2C_bus_t *bus);
+
+/**
+ * @brief Passt den Bitraten-Teiler aller Busse an eine neue SMCLK an.
+ *
+ * Wird vom clock Modul nach jedem Taktwechsel aufgerufen.
+ *
+ * @param[in] smclk_hz Neue SMCLK-Frequenz in Hz.
+ */
+void I2C_set_clock(uint32_t smclk_hz);
 
 /**
  * @brief Schreibt einen zusammenhängenden Datenblock an einen Slave.
@@ -52,15 +184,18 @@ void I2C_init(void);
  * innerhalb des Slave-Geräts interpretiert. Alle folgenden Bytes werden
  * an aufsteigende Adressen geschrieben.
  *
+ * @param[in,out] bus     Bus, an dem der Slave angeschlossen ist.
  * @param[in] slave_addr  7-Bit Slave-Adresse (links ausgerichtet, d.h. das
  *                        LSB wird von der Hardware ignoriert).
  * @param[in] data        Pointer auf den Sendepuffer.
  * @param[in] length      Anzahl der zu sendenden Bytes (≥ 1).
  *
+ * @return I2C_OK oder der Fehler des letzten Versuchs.
+ *
  * @note Die Funktion blockiert die CPU durch Eintritt in den LPM3. Die Kontrolle
  *       wird zurückgegeben, sobald die STOP-Bedingung oder NACK gesendet wurde.
  */
-void I2C_write(uint8_t slave_addr, char data[], uint8_t length);
+I2C_status_t I2C_write(I2C_bus_t *bus, uint8_t slave_addr, char data[], uint8_t length);
 
 /**
  * @brief Liest ein Byte aus einem gegebenen Register eines Slaves.
@@ -69,14 +204,89 @@ void I2C_write(uint8_t slave_addr, char data[], uint8_t length);
  *   1.  Registeradresse senden (kein STOP).
  *   2.  Repeated START gefolgt von einem Datenbyte-Empfang.
  *
- * @param[in] slave_addr  7-Bit Slave-Adresse (links ausgerichtet).
- * @param[in] reg_addr    Registeradresse innerhalb des Slaves.
+ * @param[in,out] bus      Bus, an dem der Slave angeschlossen ist.
+ * @param[in]  slave_addr  7-Bit Slave-Adresse (links ausgerichtet).
+ * @param[in]  reg_addr    Registeradresse innerhalb des Slaves.
+ * @param[out] value       Der im angeforderten Register gespeicherte Wert
+ *                         (0 bei Fehler).
  *
- * @return Der im angeforderten Register gespeicherte Wert.
+ * @return I2C_OK oder der Fehler des letzten Versuchs.
  *
  * @warning Die Routine ist blockierend und wird LPM3 betreten bis das Byte
  *          empfangen wurde.
  */
-char I2C_read_reg(uint8_t slave_addr, uint8_t reg_addr);
+I2C_status_t I2C_read_reg(I2C_bus_t *bus, uint8_t slave_addr, uint8_t reg_addr, char *value);
+
+/**
+ * @brief Prüft, ob ein Slave unter einer Adresse antwortet.
+ *
+ * Liest ein Byte ohne Registeradresse, was bei keinem der verwendeten
+ * Slaves einen Zustand ändert. Es gibt keine Wiederholung und keine
+ * Fehlerzählung, ein fehlender Slave kostet genau einen NACK.
+ *
+ * @param[in,out] bus        Bus, an dem der Slave angeschlossen sein soll.
+ * @param[in]     slave_addr 7-Bit Slave-Adresse.
+ * @return true wenn der Slave seine Adresse bestätigt hat.
+ */
+bool I2C_probe(I2C_bus_t *bus, uint8_t slave_addr);
+
+/**
+ * @brief Gibt einen blockierten Bus frei.
+ *
+ * Ein Slave, der mitten in einer Übertragung zurückgesetzt wurde, kann SDA
+ * dauerhaft auf Low halten. Die Routine schaltet SDA/SCL auf GPIO, erzeugt
+ * bis zu 9 SCL-Pulse, bis SDA frei ist, sendet eine STOP-Bedingung und
+ * initialisiert den eUSCI_B neu.
+ *
+ * @param[in,out] bus Freizugebender Bus.
+ */
+void I2C_bus_clear(I2C_bus_t *bus);
+
+/**
+ * @brief Liefert die Fehler- und Lastzähler eines Slaves.
+ *
+ * @param[in] bus         Bus, an dem der Slave angeschlossen ist.
+ * @param[in] slave_addr  7-Bit Slave-Adresse.
+ * @return Pointer auf die Zähler oder NULL, wenn mit dem Slave noch keine
+ *         Übertragung stattgefunden hat.
+ */
+const I2C_dev_stats_t *I2C_get_stats(const I2C_bus_t *bus, uint8_t slave_addr);
+
+/**
+ * @brief Liefert die Auslastung eines Busses.
+ *
+ * Ein Fenster wird mit der ersten Übertragung nach Ablauf von
+ * I2C_UTIL_WINDOW_MS oder mit diesem Aufruf abgeschlossen.
+ *
+ * @param[in,out] bus Bus.
+ * @return Anteil der Belegungszeit am letzten abgeschlossenen Fenster in %.
+ */
+uint8_t I2C_utilization(I2C_bus_t *bus);
+
+/**
+ * @brief Meldet einen zeitkritischen Ablauf auf einem Bus an.
+ *
+ * Solange ein Ablauf angemeldet ist, stellen nachrangige Teilnehmer wie
+ * das LCD ihre Übertragungen zurück (I2C_held()). Der Treiber selbst
+ * blockiert nichts.
+ *
+ * @param[in,out] bus Bus.
+ */
+void I2C_hold(I2C_bus_t *bus);
+
+/**
+ * @brief Meldet einen mit I2C_hold() angemeldeten Ablauf wieder ab.
+ *
+ * @param[in,out] bus Bus.
+ */
+void I2C_release(I2C_bus_t *bus);
+
+/**
+ * @brief Prüft, ob auf einem Bus ein zeitkritischer Ablauf angemeldet ist.
+ *
+ * @param[in] bus Bus.
+ * @return true solange nachrangige Übertragungen warten sollen.
+ */
+bool I2C_held(const I2C_bus_t *bus);
 
 #endif /* I2C_I2C_H_ */
@@ -0,0 +1,218 @@
+/* ========================================================================== */
+/* I2C_regcache.c                                                             */
+/* ========================================================================== */
+/**
+ * @file      I2C_regcache.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der I²C-Schattenregister.
+ */
+
+#include "I2C_regcache.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Verwirft den Schatten, wenn seit dem letzten Zugriff Busfehler auftraten.
+ */
+static void check_errors(I2C_regdev_t *dev)
+{
+    const I2C_dev_stats_t *stats = I2C_get_stats(dev->bus, dev->addr);
+    uint16_t errors = stats ? stats->nack + stats->timeout : 0;
+
+    if (errors != dev->errors)
+    {
+        dev->errors = errors;
+        I2C_regcache_invalidate(dev);
+    }
+}
+
+/** @brief Prüft ein Bit einer Register-Bitmap. */
+#define BITMAP_TEST(map, reg)  ((map)[(reg) >> 3] & (1U << ((reg) & 7)))
+
+/** @brief Setzt ein Bit einer Register-Bitmap. */
+#define BITMAP_SET(map, reg)   ((map)[(reg) >> 3] |= (1U << ((reg) & 7)))
+
+/** @brief Löscht ein Bit einer Register-Bitmap. */
+#define BITMAP_CLEAR(map, reg) ((map)[(reg) >> 3] &= ~(1U << ((reg) & 7)))
+
+/**
+ * @brief Prüft, ob ein Register einen gültigen Schattenwert mit @p value hat.
+ */
+static bool is_cached(const I2C_regdev_t *dev, uint16_t reg, uint8_t value)
+{
+    if (reg >= dev->size)
+        return false;
+
+    return BITMAP_TEST(dev->valid, reg) && dev->shadow[reg] == value;
+}
+
+/**
+ * @brief Übernimmt einen erfolgreich geschriebenen Registerbereich in den Schatten.
+ */
+static void update_shadow(I2C_regdev_t *dev, uint16_t reg, const uint8_t *data,
+                          uint8_t len)
+{
+    for (; len > 0 && reg < dev->size; len--, reg++, data++)
+    {
+        dev->shadow[reg] = *data;
+        BITMAP_SET(dev->valid, reg);
+    }
+}
+
+I2C_status_t I2C_regcache_write(I2C_regdev_t *dev, uint8_t reg,
+                                const uint8_t *data, uint8_t len)
+{
+    char buf[I2C_REGCACHE_MAX_BURST + 1];
+    uint8_t first = 0, last = len, i, n = 0;
+    I2C_status_t status;
+
+    if (dev->flags & I2C_REGCACHE_ABSENT)
+        return I2C_ERR_ABSENT;
+
+    if (dev->flags & I2C_REGCACHE_PORT)
+        reg = 0;
+
+    check_errors(dev);
+
+    // Unveränderte Bytes am Anfang und Ende abschneiden
+    while (first < last && is_cached(dev, (uint16_t)reg + first, data[first]))
+        first++;
+    while (last > first && is_cached(dev, (uint16_t)reg + last - 1, data[last - 1]))
+        last--;
+
+    dev->skipped += len - (last - first);
+    if (first == last)
+        return I2C_OK;
+
+    if (!(dev->flags & I2C_REGCACHE_PORT))
+    {
+        buf[n++] = (last - first > 1 ? dev->cmd_ai : dev->cmd) | (reg + first);
+    }
+    for (i = first; i < last; i++)
+    {
+        buf[n++] = data[i];
+    }
+
+    status = I2C_write(dev->bus, dev->addr, buf, n);
+
+    // Nach einem Fehler ist der Inhalt des Slaves unbekannt
+    if (status == I2C_OK)
+        update_shadow(dev, (uint16_t)reg + first, &data[first], last - first);
+    else
+        check_errors(dev);
+    return status;
+}
+
+I2C_status_t I2C_regcache_write8(I2C_regdev_t *dev, uint8_t reg, uint8_t value)
+{
+    return I2C_regcache_write(dev, reg, &value, 1);
+}
+
+void I2C_regcache_stage(I2C_regdev_t *dev, uint8_t reg,
+                        const uint8_t *data, uint8_t len)
+{
+    check_errors(dev);
+
+    for (; len > 0 && reg < dev->size; len--, reg++, data++)
+    {
+        if (is_cached(dev, reg, *data))
+            continue;
+
+        // Vorgemerkter Wert liegt im Schatten, ist aber bis zum Commit ungültig
+        dev->shadow[reg] = *data;
+        BITMAP_CLEAR(dev->valid, reg);
+        BITMAP_SET(dev->pending, reg);
+    }
+}
+
+void I2C_regcache_stage8(I2C_regdev_t *dev, uint8_t reg, uint8_t value)
+{
+    I2C_regcache_stage(dev, reg, &value, 1);
+}
+
+I2C_status_t I2C_regcache_commit(I2C_regdev_t *dev)
+{
+    char buf[I2C_REGCACHE_MAX_BURST + 1];
+    I2C_status_t result = I2C_OK, status;
+    uint8_t start = 0, end, last, reg, n;
+
+    if (dev->pending == NULL)
+        return I2C_OK;
+
+    if (dev->flags & I2C_REGCACHE_ABSENT)
+        return I2C_ERR_ABSENT;
+
+    while (start < dev->size)
+    {
+        if (!BITMAP_TEST(dev->pending, start))
+        {
+            start++;
+            continue;
+        }
+
+        // Burst bis zum letzten vorgemerkten Register erweitern, kurze Lücken
+        // mit bekanntem Inhalt werden überbrückt
+        last = start;
+        for (end = start + 1; end < dev->size && end - start < I2C_REGCACHE_MAX_BURST; end++)
+        {
+            if (BITMAP_TEST(dev->pending, end))
+                last = end;
+            else if (!BITMAP_TEST(dev->valid, end) || end - last > I2C_REGCACHE_BRIDGE)
+                break;
+        }
+
+        n = 0;
+        buf[n++] = (last > start ? dev->cmd_ai : dev->cmd) | start;
+        for (reg = start; reg <= last; reg++)
+        {
+            buf[n++] = dev->shadow[reg];
+        }
+
+        status = I2C_write(dev->bus, dev->addr, buf, n);
+
+        for (reg = start; reg <= last; reg++)
+        {
+            BITMAP_CLEAR(dev->pending, reg);
+            if (status == I2C_OK)
+                BITMAP_SET(dev->valid, reg);
+        }
+
+        if (status != I2C_OK)
+        {
+            // Fehlgeschlagene Werte bleiben ungültig und werden beim nächsten Mal gesendet
+            check_errors(dev);
+            result = status;
+        }
+        start = last + 1;
+    }
+
+    return result;
+}
+
+bool I2C_regcache_probe(I2C_regdev_t *dev)
+{
+    if (I2C_probe(dev->bus, dev->addr))
+        dev->flags &= ~I2C_REGCACHE_ABSENT;
+    else
+        dev->flags |= I2C_REGCACHE_ABSENT;
+
+    return I2C_regcache_present(dev);
+}
+
+bool I2C_regcache_present(const I2C_regdev_t *dev)
+{
+    return !(dev->flags & I2C_REGCACHE_ABSENT);
+}
+
+void I2C_regcache_invalidate(I2C_regdev_t *dev)
+{
+    uint8_t i;
+
+    for (i = 0; i < (uint8_t)((dev->size + 7) / 8); i++)
+    {
+        dev->valid[i] = 0;
+    }
+}
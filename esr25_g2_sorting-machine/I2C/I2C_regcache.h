@@ -0,0 +1,174 @@
+/* ========================================================================== */
+/* I2C_regcache.h                                                             */
+/* ========================================================================== */
+/**
+ * @file      I2C_regcache.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Schattenregister zur Unterdrückung redundanter I²C-Schreibzugriffe.
+ *
+ * Für jeden Slave wird eine Kopie der zuletzt geschriebenen Registerwerte
+ * im RAM geführt. Schreibzugriffe werden mit dieser Kopie verglichen:
+ *   - Unveränderte Bytes am Anfang und Ende eines Blocks werden nicht gesendet
+ *   - Ist der ganze Block unverändert, entfällt die Transaktion vollständig
+ *
+ * Ein Schattenwert ist nur gültig, nachdem er erfolgreich geschrieben wurde.
+ * Meldet der I²C-Treiber für den Slave einen neuen NACK oder Timeout (auch bei
+ * Lesezugriffen), gilt sein Registerinhalt als unbekannt, da er zwischenzeitlich
+ * zurückgesetzt worden sein kann. Alle Schattenwerte werden dann verworfen und
+ * beim nächsten Zugriff wieder vollständig übertragen. Nach einem bekannten
+ * Reset muss der Treiber I2C_regcache_invalidate() selbst aufrufen.
+ *
+ * Register ab @c size (z.B. PCA9685 PRESCALE) werden nicht zwischengespeichert
+ * und immer geschrieben.
+ *
+ * Zusätzlich können mehrere Registerwerte mit I2C_regcache_stage() gesammelt
+ * und mit I2C_regcache_commit() in möglichst wenigen Auto-Increment-Bursts
+ * übertragen werden. Lücken von höchstens I2C_REGCACHE_BRIDGE Registern mit
+ * bekanntem Inhalt werden dabei mitgeschrieben, da ein zusätzliches Byte
+ * günstiger ist als eine weitere Transaktion (START, Adresse, Register, STOP).
+ */
+
+#ifndef I2C_I2C_REGCACHE_H_
+#define I2C_I2C_REGCACHE_H_
+
+#include <stdint.h>
+#include "I2C/I2C.h"
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Maximale Anzahl Datenbytes je Schreibzugriff. */
+#define I2C_REGCACHE_MAX_BURST  16
+
+/** @brief Maximale Lücke bekannter Register, die in einem Burst überbrückt wird. */
+#define I2C_REGCACHE_BRIDGE     2
+
+/** @brief Flag: Slave ohne Registeradresse (z.B. PCF8574 Port-Expander). */
+#define I2C_REGCACHE_PORT       0x01
+
+/** @brief Flag: Slave hat beim Start nicht geantwortet (von I2C_regcache_probe()). */
+#define I2C_REGCACHE_ABSENT     0x02
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Beschreibung eines Slaves mit Schattenregistern.
+ *
+ * Die Puffer @c shadow (size Bytes) sowie @c valid und @c pending
+ * (je (size + 7) / 8 Bytes) werden vom jeweiligen Treiber bereitgestellt.
+ * Für Slaves mit I2C_REGCACHE_PORT darf @c pending NULL sein.
+ */
+typedef struct
+{
+    I2C_bus_t *bus;     /**< Bus, an dem der Slave angeschlossen ist */
+    uint8_t  addr;      /**< 7-Bit Slave-Adresse */
+    uint8_t  size;      /**< Anzahl zwischengespeicherter Register ab 0 */
+    uint8_t  cmd;       /**< ODER-Maske des Registerbytes für Einzelzugriffe */
+    uint8_t  cmd_ai;    /**< ODER-Maske des Registerbytes für Auto-Increment */
+    uint8_t  flags;     /**< I2C_REGCACHE_* */
+    uint8_t *shadow;    /**< Zuletzt geschriebene Werte */
+    uint8_t *valid;     /**< Gültigkeits-Bitmap der Schattenwerte */
+    uint8_t *pending;   /**< Bitmap vorgemerkter, noch nicht gesendeter Werte */
+    uint16_t skipped;   /**< Anzahl eingesparter Datenbytes */
+    uint16_t errors;    /**< Zuletzt gesehene Fehleranzahl des Slaves */
+} I2C_regdev_t;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Schreibt einen Registerblock, sofern er sich vom Schatten unterscheidet.
+ *
+ * @param[in,out] dev   Slave-Beschreibung.
+ * @param[in]     reg   Startregister (bei I2C_REGCACHE_PORT ignoriert).
+ * @param[in]     data  Zu schreibende Werte.
+ * @param[in]     len   Anzahl Bytes (1 bis I2C_REGCACHE_MAX_BURST).
+ * @return I2C_OK wenn geschrieben oder nichts zu tun war, sonst Busfehler.
+ *
+ * @note @p len darf I2C_REGCACHE_MAX_BURST nicht überschreiten.
+ */
+I2C_status_t I2C_regcache_write(I2C_regdev_t *dev, uint8_t reg,
+                                const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Schreibt ein einzelnes Register, sofern es sich vom Schatten unterscheidet.
+ *
+ * @param[in,out] dev    Slave-Beschreibung.
+ * @param[in]     reg    Registeradresse.
+ * @param[in]     value  Zu schreibender Wert.
+ * @return I2C_OK wenn geschrieben oder nichts zu tun war, sonst Busfehler.
+ */
+I2C_status_t I2C_regcache_write8(I2C_regdev_t *dev, uint8_t reg, uint8_t value);
+
+/**
+ * @brief Merkt einen Registerblock zum späteren Schreiben vor.
+ *
+ * Werte, die dem gültigen Schatten entsprechen, werden nicht vorgemerkt.
+ * Die Übertragung erfolgt erst mit I2C_regcache_commit().
+ *
+ * @param[in,out] dev   Slave-Beschreibung (nicht I2C_REGCACHE_PORT).
+ * @param[in]     reg   Startregister, muss mit dem Block unter @c size liegen.
+ * @param[in]     data  Vorzumerkende Werte.
+ * @param[in]     len   Anzahl Bytes.
+ */
+void I2C_regcache_stage(I2C_regdev_t *dev, uint8_t reg,
+                        const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Merkt ein einzelnes Register zum späteren Schreiben vor.
+ *
+ * @param[in,out] dev    Slave-Beschreibung (nicht I2C_REGCACHE_PORT).
+ * @param[in]     reg    Registeradresse unter @c size.
+ * @param[in]     value  Vorzumerkender Wert.
+ */
+void I2C_regcache_stage8(I2C_regdev_t *dev, uint8_t reg, uint8_t value);
+
+/**
+ * @brief Überträgt alle vorgemerkten Register in minimalen Bursts.
+ *
+ * Zusammenhängende Register werden als ein Auto-Increment-Burst gesendet.
+ * Schlägt ein Burst fehl, werden seine Werte verworfen und die übrigen
+ * Bursts trotzdem versucht.
+ *
+ * @param[in,out] dev Slave-Beschreibung.
+ * @return I2C_OK oder der Fehler des letzten fehlgeschlagenen Bursts.
+ */
+I2C_status_t I2C_regcache_commit(I2C_regdev_t *dev);
+
+/**
+ * @brief Prüft, ob der Slave antwortet, und merkt sich das Ergebnis.
+ *
+ * Fehlt der Slave, enden alle weiteren Schreibzugriffe sofort mit
+ * I2C_ERR_ABSENT, ohne den Bus zu belegen.
+ *
+ * @param[in,out] dev Slave-Beschreibung.
+ * @return true wenn der Slave vorhanden ist.
+ */
+bool I2C_regcache_probe(I2C_regdev_t *dev);
+
+/**
+ * @brief Liefert das Ergebnis des letzten I2C_regcache_probe().
+ *
+ * @param[in] dev Slave-Beschreibung.
+ * @return false wenn der Slave beim Start nicht geantwortet hat.
+ */
+bool I2C_regcache_present(const I2C_regdev_t *dev);
+
+/**
+ * @brief Verwirft alle Schattenwerte eines Slaves.
+ *
+ * Muss aufgerufen werden, wenn der Slave zurückgesetzt wurde oder sein
+ * Registerinhalt aus anderen Gründen unbekannt ist. Vorgemerkte Werte
+ * bleiben erhalten.
+ *
+ * @param[in,out] dev Slave-Beschreibung.
+ */
+void I2C_regcache_invalidate(I2C_regdev_t *dev);
+
+#endif /* I2C_I2C_REGCACHE_H_ */
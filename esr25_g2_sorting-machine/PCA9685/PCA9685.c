@@ -12,19 +12,42 @@
 #include "msp430fr2355.h"
 #include <stdint.h>
 #include "I2C/I2C.h"
+#include "I2C/I2C_regcache.h"
 #include "PCA9685.h"
 
+static uint8_t pca_shadow[PCA9685_REG_COUNT];
+static uint8_t pca_valid[(PCA9685_REG_COUNT + 7) / 8];
+static uint8_t pca_pending[(PCA9685_REG_COUNT + 7) / 8];
+
+/** Schattenregister des PWM-Treibers (MODE1 bis LED15_OFF_H). */
+static I2C_regdev_t pca_dev = {
+    &I2C_bus0, PCA9685_ADDR, PCA9685_REG_COUNT, 0x00, 0x00, 0,
+    pca_shadow, pca_valid, pca_pending, 0, 0
+};
+
+bool PCA9685_probe(void)
+{
+    return I2C_regcache_probe(&pca_dev);
+}
+
 void PCA9685_init()
 {
-    // PRESCALE-Wert für 50 Hz PWM setzen
+    // Registerinhalt des PCA9685 nach MCU-Reset unbekannt
+    I2C_regcache_invalidate(&pca_dev);
+
+    // PRESCALE-Wert für 50 Hz PWM setzen (wird nicht zwischengespeichert)
     // Berechnung: round(25,000,000/(4096 × 50)) - 1 = 121 (0x79)
     // Referenz: https://cdn-shop.adafruit.com/datasheets/PCA9685.pdf Seite 25
-    char PRESCALE_DATA[] = {0xFE, 0x79};
-    I2C_write(PCA9685_ADDR, PRESCALE_DATA, 2);
+    I2C_regcache_write8(&pca_dev, PCA9685_PRESCALE, 0x79);
 
     // MODE1 Register konfigurieren: Auto-Increment + ALLCALL aktivieren
-    char MODE1_AI_ALLCALL_DATA[] = {0x00, 0x21};
-    I2C_write(PCA9685_ADDR, MODE1_AI_ALLCALL_DATA, 2);
+    I2C_regcache_write8(&pca_dev, PCA9685_MODE1, 0x21);
+}
+
+void PCA9685_sleep(void)
+{
+    // MODE1: SLEEP zusätzlich zu Auto-Increment + ALLCALL
+    I2C_regcache_write8(&pca_dev, PCA9685_MODE1, 0x31);
 }
 
 void PCA9685_set_servo_position(uint8_t channel, uint16_t position)
@@ -35,7 +58,8 @@ void PCA9685_set_servo_position(uint8_t channel, uint16_t position)
     }
 
     // PWM-Register setzen: LED_ON = 0, LED_OFF = position
-    // Format: [Register, LED_ON_L, LED_ON_H, LED_OFF_L, LED_OFF_H]
-    char servo_data[] = {LED_ON_L(channel), 0x00, 0x00, (position & 0xFF), (position >> 8)};
-    I2C_write(PCA9685_ADDR, servo_data, 5);
+    // Format: [LED_ON_L, LED_ON_H, LED_OFF_L, LED_OFF_H], unveränderte Bytes
+    // werden von den Schattenregistern weggelassen
+    const uint8_t servo_data[] = {0x00, 0x00, (position & 0xFF), (position >> 8)};
+    I2C_regcache_write(&pca_dev, LED_ON_L(channel), servo_data, sizeof(servo_data));
 }
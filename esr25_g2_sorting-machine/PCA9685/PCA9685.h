@@ -25,6 +25,7 @@
 #define PCA9685_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /* ========================================================================== */
 /* Konstanten                                           */
@@ -37,6 +38,15 @@
 /* PCA9685 Registeradressen                                                   */
 /* ========================================================================== */
 
+/** @brief MODE1 Register – Sleep, Auto-Increment, ALLCALL. */
+#define PCA9685_MODE1     0x00
+
+/** @brief PRESCALE Register – Vorteiler der PWM-Frequenz. */
+#define PCA9685_PRESCALE  0xFE
+
+/** @brief Anzahl der Register von MODE1 bis LED15_OFF_H. */
+#define PCA9685_REG_COUNT 0x46
+
 /** @brief LED0_ON_L Register – Kanal 0 Ein-Zeit Low-Byte. */
 #define LED0_ON_L         0x06
 
@@ -89,6 +99,15 @@
 /** @brief PWM-Wert für 135° Servo-Position (≈ 2.33 ms Pulsweite). */
 #define SERVO_DEG_PULSE_135  477
 
+/**
+ * @brief Prüft, ob der PCA9685 antwortet.
+ *
+ * Fehlt er, kehren alle weiteren Zugriffe ohne Busverkehr zurück.
+ *
+ * @return true wenn der PCA9685 vorhanden ist.
+ */
+bool PCA9685_probe(void);
+
 /**
  * @brief Initialisiert den PCA9685 für 50 Hz PWM-Betrieb.
  *
@@ -102,6 +121,15 @@
  */
 void PCA9685_init(void);
 
+/**
+ * @brief Versetzt den PCA9685 in den SLEEP-Modus.
+ *
+ * Der Oszillator stoppt, alle Ausgänge liefern keine Pulse mehr. Das
+ * entspricht dem Zustand nach dem Einschalten, PCA9685_init() startet
+ * ihn wieder.
+ */
+void PCA9685_sleep(void);
+
 /**
  * @brief Setzt die PWM-Position eines bestimmten Kanals.
  *
@@ -11,106 +11,242 @@
 
 #include "TCS34725.h"
 #include "I2C/I2C.h"
+#include "I2C/I2C_regcache.h"
 #include <msp430.h>
 #include "intrinsics.h"
 #include "timer/timer.h"
+#include "ramfunc/ramfunc.h"
 
-void TCS_init(void)
+static uint8_t tcs0_shadow[TCS34725_REG_COUNT];
+static uint8_t tcs0_valid[(TCS34725_REG_COUNT + 7) / 8];
+static uint8_t tcs0_pending[(TCS34725_REG_COUNT + 7) / 8];
+
+static uint8_t tcs1_shadow[TCS34725_REG_COUNT];
+static uint8_t tcs1_valid[(TCS34725_REG_COUNT + 7) / 8];
+static uint8_t tcs1_pending[(TCS34725_REG_COUNT + 7) / 8];
+
+TCS_t TCS_sensor0 = {
+    {
+        &I2C_bus1, TCS34725_ADDRESS, TCS34725_REG_COUNT,
+        TCS34725_COMMAND_BIT, TCS_CMD_AI(0), 0,
+        tcs0_shadow, tcs0_valid, tcs0_pending, 0, 0
+    },
+    &P1OUT, &P1DIR, BIT7, I2C_OK
+};
+
+TCS_t TCS_sensor1 = {
+    {
+        &I2C_bus0, TCS34725_ADDRESS, TCS34725_REG_COUNT,
+        TCS34725_COMMAND_BIT, TCS_CMD_AI(0), 0,
+        tcs1_shadow, tcs1_valid, tcs1_pending, 0, 0
+    },
+    &P5OUT, &P5DIR, BIT0, I2C_OK
+};
+
+/**
+ * @brief Merkt sich den ersten Busfehler der laufenden Messung.
+ */
+static void tcs_check(TCS_t *tcs, I2C_status_t status)
+{
+    if (tcs->status == I2C_OK)
+        tcs->status = status;
+}
+
+bool TCS_probe(TCS_t *tcs)
 {
-    P1DIR |= BIT7;  // LED-Pin als Ausgang konfigurieren
-    P1OUT &= ~BIT7; // LED ausschalten
+    return I2C_regcache_probe(&tcs->dev);
+}
 
-    // Sensor aktivieren (PON = 1)
-    char enable_cmd[] = { TCS_CMD(TCS34725_ENABLE), 0x01 };
-    I2C_write(TCS34725_ADDRESS, enable_cmd, sizeof(enable_cmd));
+bool TCS_present(const TCS_t *tcs)
+{
+    return I2C_regcache_present(&tcs->dev);
+}
+
+void TCS_init(TCS_t *tcs)
+{
+    *tcs->led_dir |= tcs->led_pin;  // LED-Pin als Ausgang konfigurieren
+    *tcs->led_out &= ~tcs->led_pin; // LED ausschalten
 
-    timer_sleep_ms(3); // Warm-up ≥2.4 ms
+    // Registerinhalt des Sensors nach MCU-Reset unbekannt
+    I2C_regcache_invalidate(&tcs->dev);
 
-    // Integrationszeit auf 100 ms setzen
-    char atime_cmd[] = { TCS_CMD(TCS34725_ATIME), 0xD6 };
-    I2C_write(TCS34725_ADDRESS, atime_cmd, sizeof(atime_cmd));
+    // Register sind auch mit PON = 0 beschreibbar, daher keine Warm-up Zeit.
+    // Alle Werte werden gesammelt und als 4 Bursts übertragen:
+    // ENABLE..ATIME, AILTL..AIHTH, PERS, CONTROL
 
-    // Verstärkung auf 4x setzen
-    char control_cmd[] = { TCS_CMD(TCS34725_CONTROL), 0x01 };
-    I2C_write(TCS34725_ADDRESS, control_cmd, sizeof(control_cmd));
+    // Sensor schlafen legen (PON = 0)
+    I2C_regcache_stage8(&tcs->dev, TCS34725_ENABLE, 0x00);
 
     // Lichtschranken-Schwellenwerte setzen
-    char threshold_cmd[] = {
-        TCS_CMD_AI(0x04),  // Auto-Increment ab AILTL
+    const uint8_t threshold[] = {
         0xE8, 0x03,        // AILTL, AILTH (0x03E8 = 1000)
         0xFF, 0xFF         // AIHTL, AIHTH (0xFFFF = max)
     };
-    I2C_write(TCS34725_ADDRESS, threshold_cmd, sizeof(threshold_cmd));
+    I2C_regcache_stage(&tcs->dev, TCS34725_AILTL, threshold, sizeof(threshold));
 
     // Persistenz auf 1 Ereignis setzen
-    char pers_cmd[] = { TCS_CMD(0x0C), 0x01 };
-    I2C_write(TCS34725_ADDRESS, pers_cmd, sizeof(pers_cmd));
+    I2C_regcache_stage8(&tcs->dev, TCS34725_PERS, 0x01);
 
-    // Sensor wieder schlafen legen (PON = 0)
-    char sleep_cmd[] = { TCS_CMD(TCS34725_ENABLE), 0x00 };
-    I2C_write(TCS34725_ADDRESS, sleep_cmd, sizeof(sleep_cmd));
+    // Integrationszeit auf 100 ms und Verstärkung auf 4x setzen
+    TCS_configure(tcs, TCS34725_ATIME_100MS, TCS34725_GAIN_4X);
 }
 
-uint16_t TCS_read_16bit_reg(uint8_t reg)
+void TCS_configure(TCS_t *tcs, uint8_t atime, uint8_t gain)
 {
-    uint8_t low = I2C_read_reg(TCS34725_ADDRESS, TCS_CMD(reg));
-    uint8_t high = I2C_read_reg(TCS34725_ADDRESS, TCS_CMD(reg + 1));
-    return ((uint16_t)high << 8) | low; // Little-Endian Kombination
+    I2C_regcache_stage8(&tcs->dev, TCS34725_ATIME, atime);
+    I2C_regcache_stage8(&tcs->dev, TCS34725_CONTROL, gain);
+    I2C_regcache_commit(&tcs->dev);
+}
+
+uint16_t TCS_read_16bit_reg(TCS_t *tcs, uint8_t reg)
+{
+    char low = 0, high = 0;
+
+    if (!TCS_present(tcs))
+    {
+        tcs_check(tcs, I2C_ERR_ABSENT);
+        return 0;
+    }
+
+    tcs_check(tcs, I2C_read_reg(tcs->dev.bus, tcs->dev.addr, TCS_CMD(reg), &low));
+    tcs_check(tcs, I2C_read_reg(tcs->dev.bus, tcs->dev.addr, TCS_CMD(reg + 1), &high));
+    return ((uint16_t)(uint8_t)high << 8) | (uint8_t)low; // Little-Endian Kombination
 }
 
-void TCS_read_clear(uint16_t *clear)
+I2C_status_t TCS_power_on(TCS_t *tcs, bool led)
 {
+    tcs->status = I2C_OK;
+
+    if (led)
+        TCS_led_on(tcs); // LED einschalten
+
     /* Power-On (PON) */
-    char pon[] = { TCS_CMD(TCS34725_ENABLE), 0x01 };
-    I2C_write(TCS34725_ADDRESS, pon, 2);
-    timer_sleep_ms(3);                       // Warm-up ≥2.4 ms
+    tcs_check(tcs, I2C_regcache_write8(&tcs->dev, TCS34725_ENABLE, 0x01));
 
-    /* ADC starten (PON|AEN) */
-    char aen[] = { TCS_CMD(TCS34725_ENABLE), 0x03 };
-    I2C_write(TCS34725_ADDRESS, aen, 2);
+    return tcs->status;
+}
 
-        // Wartezeit für Messung (ATIME = 100ms + Puffer)
-    timer_sleep_ms(120);
+I2C_status_t TCS_start_adc(TCS_t *tcs)
+{
+    /* ADC starten (PON|AEN) */
+    tcs_check(tcs, I2C_regcache_write8(&tcs->dev, TCS34725_ENABLE, 0x03));
 
-    /* Clear-Kanal lesen */
-    *clear = TCS_read_16bit_reg(TCS34725_CDATAL);
+    return tcs->status;
+}
 
+void TCS_power_off(TCS_t *tcs)
+{
     /* Sensor vollständig ausschalten (PON = 0) */
-    char off[] = { TCS_CMD(TCS34725_ENABLE), 0x00 };
-    I2C_write(TCS34725_ADDRESS, off, 2);
+    tcs_check(tcs, I2C_regcache_write8(&tcs->dev, TCS34725_ENABLE, 0x00));
+
+    TCS_led_off(tcs); // LED ausschalten
 }
 
+PT_THREAD(TCS_measure(pt_t *pt, TCS_t *tcs, bool led, uint16_t integration_ms))
+{
+    PT_BEGIN(pt);
+
+    TCS_power_on(tcs, led);
+    PT_WAIT_MS(pt, TCS_WARMUP_MS);
 
-void TCS_get_rgb(uint8_t *r8, uint8_t *g8, uint8_t *b8)
+    TCS_start_adc(tcs);
+    PT_WAIT_MS(pt, integration_ms);
+
+    PT_END(pt);
+}
+
+I2C_status_t TCS_peek_clear(TCS_t *tcs, uint16_t *clear)
 {
-    TCS_led_on(); // LED einschalten
-    uint16_t r, g, b, c;
+    *clear = TCS_read_16bit_reg(tcs, TCS34725_CDATAL);
 
-    // Sensor aktivieren (PON = 1)
-    char enable_cmd[] = { TCS_CMD(TCS34725_ENABLE), 0x01 };
-    I2C_write(TCS34725_ADDRESS, enable_cmd, 2);
+    return tcs->status;
+}
 
-    timer_sleep_ms(3); // Wartezeit für Sensor-Warm-up
+I2C_status_t TCS_fetch_clear(TCS_t *tcs, uint16_t *clear)
+{
+    /* Clear-Kanal lesen */
+    *clear = TCS_read_16bit_reg(tcs, TCS34725_CDATAL);
 
-    // ADC starten (PON | AEN)
-    char adc_cmd[] = { TCS_CMD(TCS34725_ENABLE), 0x03 };
-    I2C_write(TCS34725_ADDRESS, adc_cmd, 2);
+    TCS_power_off(tcs);
 
-    // Wartezeit für Messung (ATIME = 100ms + Puffer)
-    timer_sleep_ms(120);
+    return tcs->status;
+}
 
+I2C_status_t TCS_fetch_rgbc(TCS_t *tcs, uint16_t *c, uint16_t *r, uint16_t *g, uint16_t *b)
+{
     // RGBC-Werte auslesen
-    c = TCS_read_16bit_reg(TCS34725_CDATAL);
-    r = TCS_read_16bit_reg(TCS34725_RDATAL);
-    g = TCS_read_16bit_reg(TCS34725_GDATAL);
-    b = TCS_read_16bit_reg(TCS34725_BDATAL);
+    *c = TCS_read_16bit_reg(tcs, TCS34725_CDATAL);
+    *r = TCS_read_16bit_reg(tcs, TCS34725_RDATAL);
+    *g = TCS_read_16bit_reg(tcs, TCS34725_GDATAL);
+    *b = TCS_read_16bit_reg(tcs, TCS34725_BDATAL);
+
+    TCS_power_off(tcs);
+
+    return tcs->status;
+}
+
+I2C_status_t TCS_read_clear(TCS_t *tcs, uint16_t *clear)
+{
+    TCS_power_on(tcs, false);
+    timer_sleep_ms(TCS_WARMUP_MS);
 
-    // Sensor ausschalten
-    char sleep_cmd[] = { TCS_CMD(TCS34725_ENABLE), 0x00 };
-    I2C_write(TCS34725_ADDRESS, sleep_cmd, 2);
+    TCS_start_adc(tcs);
+    timer_sleep_ms(TCS_INTEGRATION_MS);
 
-    TCS_led_off(); // LED ausschalten
+    return TCS_fetch_clear(tcs, clear);
+}
+
+I2C_status_t TCS_read_rgbc(TCS_t *tcs, uint16_t *c, uint16_t *r, uint16_t *g, uint16_t *b)
+{
+    TCS_power_on(tcs, true);
+    timer_sleep_ms(TCS_WARMUP_MS);
+
+    TCS_start_adc(tcs);
+    timer_sleep_ms(TCS_INTEGRATION_MS);
+
+    return TCS_fetch_rgbc(tcs, c, r, g, b);
+}
+
+static uint16_t subtract_sat(uint16_t lit, uint16_t ambient)
+{
+    return (lit > ambient) ? lit - ambient : 0;
+}
 
+void TCS_subtract_ambient(const TCS_rgbc_t *lit, const TCS_rgbc_t *ambient,
+                          TCS_rgbc_t *comp)
+{
+    comp->c = subtract_sat(lit->c, ambient->c);
+    comp->r = subtract_sat(lit->r, ambient->r);
+    comp->g = subtract_sat(lit->g, ambient->g);
+    comp->b = subtract_sat(lit->b, ambient->b);
+}
+
+I2C_status_t TCS_read_rgbc_compensated(TCS_t *tcs, TCS_rgbc_t *ambient,
+                                       TCS_rgbc_t *raw, TCS_rgbc_t *comp)
+{
+    I2C_status_t status;
+
+    // Umgebungslicht ohne LED
+    TCS_power_on(tcs, false);
+    timer_sleep_ms(TCS_WARMUP_MS);
+
+    TCS_start_adc(tcs);
+    timer_sleep_ms(TCS_INTEGRATION_MS);
+
+    status = TCS_fetch_rgbc(tcs, &ambient->c, &ambient->r, &ambient->g, &ambient->b);
+
+    // Direkt danach mit LED, TCS_power_on() setzt den Fehlerstatus zurück
+    if (TCS_read_rgbc(tcs, &raw->c, &raw->r, &raw->g, &raw->b) != I2C_OK)
+        status = tcs->status;
+
+    TCS_subtract_ambient(raw, ambient, comp);
+
+    return status;
+}
+
+RAMFUNC void TCS_scale_rgb(uint16_t c, uint16_t r, uint16_t g, uint16_t b,
+                   uint8_t *r8, uint8_t *g8, uint8_t *b8)
+{
     // Wenn der Clear-Kanal-Wert 0 ist, RGB-Werte auf 0 setzen
     if (!c) {
         *r8 = *g8 = *b8 = 0;
@@ -135,12 +271,20 @@ void TCS_get_rgb(uint8_t *r8, uint8_t *g8, uint8_t *b8)
     *b8 = b;
 }
 
-void TCS_led_on(void)
+void TCS_get_rgb(TCS_t *tcs, uint8_t *r8, uint8_t *g8, uint8_t *b8)
+{
+    TCS_rgbc_t ambient, raw, comp;
+
+    TCS_read_rgbc_compensated(tcs, &ambient, &raw, &comp);
+    TCS_scale_rgb(comp.c, comp.r, comp.g, comp.b, r8, g8, b8);
+}
+
+void TCS_led_on(const TCS_t *tcs)
 {
-    P1OUT |= BIT7; // LED einschalten
+    *tcs->led_out |= tcs->led_pin; // LED einschalten
 }
 
-void TCS_led_off(void)
+void TCS_led_off(const TCS_t *tcs)
 {
-    P1OUT &= ~BIT7; // LED ausschalten
+    *tcs->led_out &= ~tcs->led_pin; // LED ausschalten
 }
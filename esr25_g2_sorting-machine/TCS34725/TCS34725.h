@@ -9,26 +9,52 @@
  * @brief     TCS34725 RGB-Farbsensor Treiber für Embedded-Anwendungen.
  *
  * Dieses Modul bietet eine einfache Schnittstelle zum TCS34725 RGB-Farbsensor
- * über I²C-Kommunikation. Der Treiber bietet grundlegende Funktionalität für:
+ über I²C-Kommunikation. Jeder Sensor wird durch eine eigene Instanz (TCS_t)
+ * mit Bus, Schattenregistern und LED-Pin beschrieben:
+ *   - TCS_sensor0 – I2C_bus1, LED an P1.7
+ *   - TCS_sensor1 – I2C_bus0, LED an P5.0 (feste Adresse 0x29, daher auf dem
+ *     Bus von PCA9685 und LCD, siehe lane.h)
+ *
+ * Der Treiber bietet grundlegende Funktionalität für:
  *   - TCS_init()         – Sensor mit 100ms Integration, 4x Verstärkung initialisieren
  *   - TCS_read_16bit_reg() – 16-Bit Register vom Sensor lesen
  *   - TCS_read_clear()   – Clear-Kanal-Wert lesen
- *   - TCS_get_rgbc()     – RGBC-Werte lesen und zu 8-Bit RGB konvertieren
+ *   - TCS_read_rgbc()    – RGBC-Rohwerte mit LED-Beleuchtung lesen
+ *   - TCS_scale_rgb()    – Rohwerte zu 8-Bit RGB konvertieren
+ *   - TCS_read_rgbc_compensated() – Messung ohne und mit LED, Umgebungslicht abziehen
+ *   - TCS_get_rgb()      – Kompensierte RGBC-Werte lesen und zu 8-Bit RGB konvertieren
  *   - TCS_led_on/off()   – LED-Steuerung
  *
+ * Für nicht blockierende Abläufe ist eine Messung zusätzlich in Schritte
+ * zerlegt, zwischen denen der Aufrufer TCS_WARMUP_MS bzw.
+ * TCS_INTEGRATION_MS abwarten muss:
+ *   - TCS_power_on()  – Sensor (und optional LED) einschalten
+ *   - TCS_start_adc() – Integration starten
+ *   - TCS_fetch_clear() / TCS_fetch_rgbc() – Ergebnis lesen, Sensor aus
+ *   - TCS_peek_clear() – Clear-Kanal lesen, Sensor bleibt an
+ *   - TCS_subtract_ambient() – Messung ohne LED von Messung mit LED abziehen
+ *
+ * TCS_measure() fasst die ersten beiden Schritte samt Wartezeiten als
+ * Protothread zusammen (siehe pt.h).
+ *
  * Die Konvertierung zu 8-Bit RGB ist vereinfacht und für Farbunterscheidung
  * optimiert, nicht für akkurate Farbwiedergabe. Sie erhält relative Farbverhältnisse
  * und stellt sicher, dass alle Werte in den 8-Bit Bereich passen.
  *
- * @note Dieser Treiber benötigt eine funktionsfähige I²C-Schnittstelle und nimmt an,
- *       dass der Sensor am Standard-I²C-Bus angeschlossen ist. Vor Verwendung anderer
- *       Funktionen muss die TCS_init() Methode aufgerufen werden.
+ * @note Dieser Treiber benötigt eine funktionsfähige I²C-Schnittstelle. Da die
+ *       Slave-Adresse fest ist, muss jeder Sensor an einem eigenen Bus hängen.
+ *       Vor Verwendung anderer Funktionen muss die TCS_init() Methode für
+ *       jeden Sensor aufgerufen werden.
  */
 
 #ifndef TCS34725_H_
 #define TCS34725_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "I2C/I2C.h"
+#include "I2C/I2C_regcache.h"
+#include "pt/pt.h"
 
 /* ========================================================================== */
 /* TCS34725 Konfigurationskonstanten                                          */
@@ -40,6 +66,18 @@
 /** @brief Command-Bit erforderlich für alle Registerzugriffe. */
 #define TCS34725_COMMAND_BIT 0x80
 
+/** @brief Anzahl der zwischengespeicherten Register (ENABLE bis CONTROL). */
+#define TCS34725_REG_COUNT   0x10
+
+/** @brief Warm-up nach Power-On bis zum Start der Integration in ms (≥ 2.4 ms). */
+#define TCS_WARMUP_MS        3
+
+/** @brief Wartezeit für eine Integration in ms (ATIME = 100 ms + Puffer). */
+#define TCS_INTEGRATION_MS   120
+
+/** @brief Wartezeit für eine kurze Integration in ms (ATIME = 24 ms + Puffer). */
+#define TCS_FAST_INTEGRATION_MS 30
+
 /* ========================================================================== */
 /* TCS34725 Registeradressen                                                  */
 /* ========================================================================== */
@@ -50,6 +88,12 @@
 /** @brief ATIME-Register – ADC-Integrationszeitkonfiguration. */
 #define TCS34725_ATIME       0x01
 
+/** @brief AILTL-Register – Unterer Interrupt-Schwellenwert (Low-Byte). */
+#define TCS34725_AILTL       0x04
+
+/** @brief PERS-Register – Interrupt-Persistenz. */
+#define TCS34725_PERS        0x0C
+
 /** @brief Control-Register – Analoge Verstärkungseinstellung. */
 #define TCS34725_CONTROL     0x0F
 
@@ -65,6 +109,22 @@
 /** @brief Blau-Kanal Datenregister (Low-Byte). */
 #define TCS34725_BDATAL      0x1A
 
+/* ========================================================================== */
+/* Integrationszeiten (ATIME-Register)                                        */
+/* ========================================================================== */
+
+#define TCS34725_ATIME_100MS 0xD6 /**< 42 Zyklen, 100.8 ms (Standard) */
+#define TCS34725_ATIME_24MS  0xF6 /**< 10 Zyklen, 24 ms (schnelle Abfrage) */
+
+/* ========================================================================== */
+/* Verstärkungsstufen (CONTROL-Register)                                      */
+/* ========================================================================== */
+
+#define TCS34725_GAIN_1X     0x00 /**< 1x Verstärkung */
+#define TCS34725_GAIN_4X     0x01 /**< 4x Verstärkung */
+#define TCS34725_GAIN_16X    0x02 /**< 16x Verstärkung */
+#define TCS34725_GAIN_60X    0x03 /**< 60x Verstärkung */
+
 /* ========================================================================== */
 /* Hilfsmakros                                                                */
 /* ========================================================================== */
@@ -96,12 +156,64 @@
  */
 #define TCS_CMD_AI(reg)  (TCS34725_COMMAND_BIT | 0x20 | (reg))
 
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Instanz eines TCS34725 Sensors.
+ */
+typedef struct
+{
+    I2C_regdev_t      dev;      /**< Bus, Adresse und Schattenregister */
+    volatile uint8_t *led_out;  /**< PxOUT des LED-Pins */
+    volatile uint8_t *led_dir;  /**< PxDIR des LED-Pins */
+    uint8_t           led_pin;  /**< Bitmaske des LED-Pins */
+    I2C_status_t      status;   /**< Erster Busfehler der laufenden Messung */
+} TCS_t;
+
+/**
+ * @brief Werte aller vier Kanäle einer Messung.
+ */
+typedef struct
+{
+    uint16_t c; /**< Clear-Kanal */
+    uint16_t r; /**< Rot-Kanal */
+    uint16_t g; /**< Grün-Kanal */
+    uint16_t b; /**< Blau-Kanal */
+} TCS_rgbc_t;
+
+/** @brief Sensor an I2C_bus1, LED an P1.7. */
+extern TCS_t TCS_sensor0;
+
+/** @brief Sensor an I2C_bus0, LED an P5.0. */
+extern TCS_t TCS_sensor1;
+
 /* ========================================================================== */
 /* Funktionen                                                                 */
 /* ========================================================================== */
 
 /**
- * @brief Initialisiert den TCS34725 Farbsensor.
+ * @brief Prüft, ob der Sensor antwortet.
+ *
+ * Fehlt er, kehren alle weiteren Zugriffe ohne Busverkehr mit
+ * I2C_ERR_ABSENT zurück.
+ *
+ * @param[in,out] tcs Sensor.
+ * @return true wenn der Sensor vorhanden ist.
+ */
+bool TCS_probe(TCS_t *tcs);
+
+/**
+ * @brief Liefert das Ergebnis von TCS_probe().
+ *
+ * @param[in] tcs Sensor.
+ * @return false wenn der Sensor beim Start nicht geantwortet hat.
+ */
+bool TCS_present(const TCS_t *tcs);
+
+/**
+ * @brief Initialisiert einen TCS34725 Farbsensor.
  *
  * Konfiguriert den Sensor mit Standardeinstellungen:
  *   - Integrationszeit: 100ms 
@@ -110,10 +222,26 @@
  *   - Persistenz auf 1 Ereignis
  *   - Sensor wird nach Initialisierung in Schlafmodus versetzt
  *
+ * Alle Register werden gesammelt und als Auto-Increment-Bursts übertragen.
+ *
+ * @param[in,out] tcs Zu initialisierender Sensor.
+ *
  * @note Der Sensor wird nach der Initialisierung ausgeschaltet und muss
  *       für Messungen explizit aktiviert werden.
  */
-void TCS_init(void);
+void TCS_init(TCS_t *tcs);
+
+/**
+ * @brief Setzt Integrationszeit und Verstärkung.
+ *
+ * Nur geänderte Register werden übertragen. Beide Werte werden gemeinsam
+ * vorgemerkt und in einem Schritt geschrieben.
+ *
+ * @param[in,out] tcs Sensor.
+ * @param[in] atime ATIME-Registerwert (Integrationszeit = (256 - atime) × 2.4 ms).
+ * @param[in] gain  Verstärkung (TCS34725_GAIN_*).
+ */
+void TCS_configure(TCS_t *tcs, uint8_t atime, uint8_t gain);
 
 /**
  * @brief Liest einen 16-Bit Wert vom TCS34725 aus.
@@ -121,10 +249,87 @@ void TCS_init(void);
  * Liest zwei aufeinanderfolgende Register und kombiniert sie zu einem 16-Bit Wert.
  * Little-Endian Reihenfolge (Low-Byte zuerst).
  *
+ * @param[in,out] tcs Sensor.
  * @param[in] reg Startregisteradresse (Low-Byte).
  * @return Kombinierter 16-Bit Wert aus dem Registerpaar.
  */
-uint16_t TCS_read_16bit_reg(uint8_t reg);
+uint16_t TCS_read_16bit_reg(TCS_t *tcs, uint8_t reg);
+
+/**
+ * @brief Schaltet den Sensor ein (PON) und beginnt eine Messung.
+ *
+ * Setzt den Fehlerstatus der Messung zurück. Vor TCS_start_adc() müssen
+ * TCS_WARMUP_MS abgewartet werden.
+ *
+ * @param[in,out] tcs Sensor.
+ * @param[in] led true um die Beleuchtung für eine Farbmessung einzuschalten.
+ * @return I2C_OK oder der erste Busfehler der Messung.
+ */
+I2C_status_t TCS_power_on(TCS_t *tcs, bool led);
+
+/**
+ * @brief Startet die Integration (PON | AEN).
+ *
+ * Das Ergebnis ist nach TCS_INTEGRATION_MS verfügbar.
+ *
+ * @param[in,out] tcs Sensor.
+ * @return I2C_OK oder der erste Busfehler der Messung.
+ */
+I2C_status_t TCS_start_adc(TCS_t *tcs);
+
+/**
+ * @brief Liest den Clear-Kanal und schaltet Sensor und LED aus.
+ *
+ * @param[in,out] tcs  Sensor.
+ * @param[out] clear   Pointer zum Speichern des 16-Bit Clear-Kanal-Werts.
+ * @return I2C_OK oder der erste Busfehler der Messung.
+ */
+I2C_status_t TCS_fetch_clear(TCS_t *tcs, uint16_t *clear);
+
+/**
+ * @brief Liest den Clear-Kanal, ohne den Sensor auszuschalten.
+ *
+ * Danach folgt TCS_fetch_rgbc() für die übrigen Kanäle derselben Messung
+ * oder TCS_power_off().
+ *
+ * @param[in,out] tcs  Sensor.
+ * @param[out] clear   Pointer zum Speichern des 16-Bit Clear-Kanal-Werts.
+ * @return I2C_OK oder der erste Busfehler der Messung.
+ */
+I2C_status_t TCS_peek_clear(TCS_t *tcs, uint16_t *clear);
+
+/**
+ * @brief Liest alle vier Kanäle und schaltet Sensor und LED aus.
+ *
+ * @param[in,out] tcs Sensor.
+ * @param[out] c  Pointer zum Speichern des Clear-Rohwerts.
+ * @param[out] r  Pointer zum Speichern des Rot-Rohwerts.
+ * @param[out] g  Pointer zum Speichern des Grün-Rohwerts.
+ * @param[out] b  Pointer zum Speichern des Blau-Rohwerts.
+ * @return I2C_OK oder der erste Busfehler der Messung.
+ */
+I2C_status_t TCS_fetch_rgbc(TCS_t *tcs, uint16_t *c, uint16_t *r, uint16_t *g, uint16_t *b);
+
+/**
+ * @brief Bricht eine laufende Messung ab und schaltet Sensor und LED aus.
+ *
+ * @param[in,out] tcs Sensor.
+ */
+void TCS_power_off(TCS_t *tcs);
+
+/**
+ * @brief Protothread für eine Messung ohne Auslesen.
+ *
+ * Schaltet den Sensor ein, wartet TCS_WARMUP_MS, startet die Integration
+ * und wartet @p integration_ms. Danach liefert TCS_fetch_clear() bzw.
+ * TCS_fetch_rgbc() das Ergebnis. Wird mit PT_SPAWN() ausgeführt.
+ *
+ * @param[in,out] pt  Zustand des Kind-Protothreads.
+ * @param[in,out] tcs Sensor.
+ * @param[in] led            true um die Beleuchtung einzuschalten.
+ * @param[in] integration_ms Zur eingestellten ATIME passende Integrationszeit.
+ */
+PT_THREAD(TCS_measure(pt_t *pt, TCS_t *tcs, bool led, uint16_t integration_ms));
 
 /**
  * @brief Liest den Clear-Kanal-Wert vom TCS34725.
@@ -132,17 +337,84 @@ uint16_t TCS_read_16bit_reg(uint8_t reg);
  * Aktiviert den Sensor, führt eine Messung durch und liest den Clear-Kanal aus.
  * Der Sensor wird nach der Messung wieder ausgeschaltet.
  *
- * @param[out] clear Pointer zum Speichern des 16-Bit Clear-Kanal-Werts.
+ * @param[in,out] tcs  Sensor.
+ * @param[out] clear   Pointer zum Speichern des 16-Bit Clear-Kanal-Werts.
+ * @return I2C_OK oder der erste Busfehler während der Messung.
+ *
+ * @note Die Funktion wartet die komplette Integrationszeit (120ms) ab.
+ */
+I2C_status_t TCS_read_clear(TCS_t *tcs, uint16_t *clear);
+
+/**
+ * @brief Liest die RGBC-Rohwerte mit eingeschalteter LED.
+ *
+ * Aktiviert den Sensor mit LED, führt eine Messung durch und liefert die
+ * unveränderten 16-Bit Werte aller vier Kanäle.
+ *
+ * @param[in,out] tcs Sensor.
+ * @param[out] c  Pointer zum Speichern des Clear-Rohwerts.
+ * @param[out] r  Pointer zum Speichern des Rot-Rohwerts.
+ * @param[out] g  Pointer zum Speichern des Grün-Rohwerts.
+ * @param[out] b  Pointer zum Speichern des Blau-Rohwerts.
+ * @return I2C_OK oder der erste Busfehler während der Messung.
  *
  * @note Die Funktion wartet die komplette Integrationszeit (120ms) ab.
  */
-void TCS_read_clear(uint16_t *clear);
+I2C_status_t TCS_read_rgbc(TCS_t *tcs, uint16_t *c, uint16_t *r, uint16_t *g, uint16_t *b);
+
+/**
+ * @brief Zieht das Umgebungslicht kanalweise von einer Messung mit LED ab.
+ *
+ * Beide Messungen müssen mit derselben Integrationszeit und Verstärkung
+ * aufgenommen sein. Kanäle, in denen die Umgebung heller war als die
+ * Messung mit LED, werden auf 0 begrenzt.
+ *
+ * @param[in]  lit     Rohwerte mit LED.
+ * @param[in]  ambient Rohwerte ohne LED.
+ * @param[out] comp    Kompensierte Werte (darf gleich @p lit sein).
+ */
+void TCS_subtract_ambient(const TCS_rgbc_t *lit, const TCS_rgbc_t *ambient,
+                          TCS_rgbc_t *comp);
+
+/**
+ * @brief Misst ohne und direkt danach mit LED und kompensiert das Umgebungslicht.
+ *
+ * Die LED leuchtet nur während der zweiten Integration.
+ *
+ * @param[in,out] tcs Sensor.
+ * @param[out] ambient Rohwerte ohne LED.
+ * @param[out] raw     Rohwerte mit LED.
+ * @param[out] comp    raw abzüglich ambient.
+ * @return I2C_OK oder der erste Busfehler während der Messungen.
+ *
+ * @note Die Funktion wartet zwei komplette Integrationszeiten (2 x 120ms) ab.
+ */
+I2C_status_t TCS_read_rgbc_compensated(TCS_t *tcs, TCS_rgbc_t *ambient,
+                                       TCS_rgbc_t *raw, TCS_rgbc_t *comp);
+
+/**
+ * @brief Konvertiert RGBC-Rohwerte zu 8-Bit RGB.
+ *
+ * Skaliert alle Kanäle proportional per Bit-Verschiebung, bis der größte
+ * Kanal in 8 Bit passt. Ist der Clear-Kanal 0, werden alle Werte 0.
+ *
+ * @param[in]  c   Clear-Rohwert.
+ * @param[in]  r   Rot-Rohwert.
+ * @param[in]  g   Grün-Rohwert.
+ * @param[in]  b   Blau-Rohwert.
+ * @param[out] r8  Pointer zum Speichern des 8-Bit Rot-Werts.
+ * @param[out] g8  Pointer zum Speichern des 8-Bit Grün-Werts.
+ * @param[out] b8  Pointer zum Speichern des 8-Bit Blau-Werts.
+ */
+void TCS_scale_rgb(uint16_t c, uint16_t r, uint16_t g, uint16_t b,
+                   uint8_t *r8, uint8_t *g8, uint8_t *b8);
 
 /**
  * @brief Liest RGB-Werte und konvertiert zu 8-Bit RGB für Farberkennung.
  *
- * Aktiviert den Sensor mit LED, führt eine Messung durch und konvertiert
- * die rohen 16-Bit Werte zu 8-Bit RGB-Werten. Die Konvertierung ist für
+ * Führt eine Messung mit Umgebungslicht-Kompensation durch (siehe
+ * TCS_read_rgbc_compensated()) und konvertiert die kompensierten 16-Bit
+ * Werte zu 8-Bit RGB-Werten. Die Konvertierung ist für
  * Farbunterscheidung optimiert, nicht für akkurate Farbwiedergabe.
  *
  * Die Konvertierung:
@@ -150,6 +422,7 @@ void TCS_read_clear(uint16_t *clear);
  *   - Verwendet Bit-Verschiebungen für Effizienz
  *   - Erhält relative Farbverhältnisse
  *
+ * @param[in,out] tcs Sensor.
  * @param[out] r8  Pointer zum Speichern des 8-Bit Rot-Werts.
  * @param[out] g8  Pointer zum Speichern des 8-Bit Grün-Werts.
  * @param[out] b8  Pointer zum Speichern des 8-Bit Blau-Werts.
@@ -157,21 +430,25 @@ void TCS_read_clear(uint16_t *clear);
  * @warning Dies ist nicht geeignet für akkurate Farbbestimmung oder
  *          Farbtemperaturmessungen.
  */
-void TCS_get_rgb(uint8_t *r8, uint8_t *g8, uint8_t *b8);
+void TCS_get_rgb(TCS_t *tcs, uint8_t *r8, uint8_t *g8, uint8_t *b8);
 
 /**
- * @brief Schaltet die TCS34725 LED ein.
+ * @brief Schaltet die LED eines Sensors ein.
  *
- * Aktiviert die weiße LED am Pin P1.7 für gleichmäßige Beleuchtung
+ * Aktiviert die weiße LED für gleichmäßige Beleuchtung
  * während der Farbmessung.
+ *
+ * @param[in] tcs Sensor.
  */
-void TCS_led_on(void);
+void TCS_led_on(const TCS_t *tcs);
 
 /**
- * @brief Schaltet die TCS34725 LED aus.
+ * @brief Schaltet die LED eines Sensors aus.
+ *
+ * Deaktiviert die weiße LED zur Energieeinsparung.
  *
- * Deaktiviert die weiße LED am Pin P1.7 zur Energieeinsparung.
+ * @param[in] tcs Sensor.
  */
-void TCS_led_off(void);
+void TCS_led_off(const TCS_t *tcs);
 
 #endif /* TCS34725_H_ */
@@ -77,6 +77,12 @@ inline void button_debounce_start(void)
     P2IE &= ~BIT3;
 }
 
+void button_replay(uint16_t event)
+{
+    EVENT_POST(event);
+    button_debounce_start();
+}
+
 /**
  * @brief Interrupt Service Routine für Port 4 (Button 1).
  *
@@ -88,7 +94,7 @@ __interrupt void Port_4_ISR(void)
 {
     if (!debounce_active)
     {
-        eventBits |= EVT_S1;
+        EVENT_POST(EVT_S1);
         button_debounce_start();
         _bic_SR_register_on_exit(LPM3_bits);
     }
@@ -106,7 +112,7 @@ __interrupt void Port_2_ISR(void)
 {
     if (!debounce_active)
     {
-        eventBits |= EVT_S2;
+        EVENT_POST(EVT_S2);
         button_debounce_start();
         _bic_SR_register_on_exit(LPM3_bits);
     }
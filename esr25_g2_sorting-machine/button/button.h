@@ -34,4 +34,14 @@ void button_init(void);
  */
 inline void button_debounce_start(void);
 
+/**
+ * @brief Meldet einen Tastendruck, der vor button_init() erfolgte.
+ *
+ * Setzt das Event wie die ISR und startet das Debouncing. Für den
+ * Taster, der die MCU aus dem Standby geweckt hat.
+ *
+ * @param[in] event EVT_S1 oder EVT_S2.
+ */
+void button_replay(uint16_t event);
+
 #endif /* BUTTON_H_ */
@@ -0,0 +1,124 @@
+/* ========================================================================== */
+/* clock.c                                                                    */
+/* ========================================================================== */
+/**
+ * @file      clock.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der Taktprofile.
+ */
+
+#include "clock.h"
+#include <msp430.h>
+#include <stddef.h>
+
+/** @brief Frequenz der FLL-Referenz REFO in Hz. */
+#define REFO_HZ 32768UL
+
+/**
+ * @brief Parameter eines Taktprofils.
+ */
+typedef struct
+{
+    uint16_t dcorsel;  /**< DCO Frequenzbereich (CSCTL1) */
+    uint16_t flln;     /**< FLL Multiplikator - 1 (CSCTL2) */
+    uint16_t nwaits;   /**< FRAM Wartezyklen (FRCTL0) */
+} clock_config_t;
+
+/** DCOCLKDIV = REFO × (FLLN + 1) */
+static const clock_config_t profiles[CLOCK_PROFILE_COUNT] = {
+    { DCORSEL_0, 31,  NWAITS_0 },   /* 1,048 MHz (Reset-Standard) */
+    { DCORSEL_3, 243, NWAITS_0 },   /* 7,995 MHz */
+    { DCORSEL_5, 487, NWAITS_1 },   /* 15,991 MHz */
+    { DCORSEL_7, 731, NWAITS_2 },   /* 23,986 MHz */
+};
+
+static clock_profile_t current = CLOCK_1MHZ;
+
+static clock_listener_t listeners[CLOCK_MAX_LISTENERS];
+
+/**
+ * @brief Stellt DCO und FLL auf ein Profil ein und wartet auf das Einrasten.
+ */
+static void configure_dco(const clock_config_t *cfg)
+{
+    __bis_SR_register(SCG0);                // FLL deaktivieren
+    CSCTL3 |= SELREF__REFOCLK;              // REFO als FLL Referenz
+    CSCTL0 = 0;                             // DCO Tap und Modulation löschen
+    CSCTL1 = cfg->dcorsel;
+    CSCTL2 = FLLD_0 + cfg->flln;            // DCOCLKDIV = DCOCLK
+    __delay_cycles(3);
+    __bic_SR_register(SCG0);                // FLL aktivieren
+
+    while (CSCTL7 & (FLLUNLOCK0 | FLLUNLOCK1))
+        ;                                   // Warten bis FLL eingerastet
+}
+
+void clock_init(void)
+{
+    current = CLOCK_PROFILE_COUNT;
+    clock_set_profile(CLOCK_PROFILE_IDLE);
+}
+
+void clock_set_profile(clock_profile_t profile)
+{
+    uint16_t gie;
+    uint8_t i;
+
+    if (profile >= CLOCK_PROFILE_COUNT || profile == current)
+        return;
+
+    gie = __get_SR_register() & GIE;
+    __disable_interrupt();
+
+    // Wartezyklen vor dem Hochtakten erhöhen
+    if (current == CLOCK_PROFILE_COUNT || profile > current)
+        FRCTL0 = FRCTLPW | profiles[profile].nwaits;
+
+    configure_dco(&profiles[profile]);
+
+    // Wartezyklen erst nach dem Heruntertakten verringern
+    FRCTL0 = FRCTLPW | profiles[profile].nwaits;
+
+    current = profile;
+
+    for (i = 0; i < CLOCK_MAX_LISTENERS && listeners[i] != NULL; i++)
+    {
+        listeners[i](clock_smclk_hz());
+    }
+
+    __bis_SR_register(gie);
+}
+
+clock_profile_t clock_get_profile(void)
+{
+    return current;
+}
+
+uint32_t clock_mclk_hz(void)
+{
+    clock_profile_t profile = (current < CLOCK_PROFILE_COUNT) ? current : CLOCK_1MHZ;
+
+    return REFO_HZ * (profiles[profile].flln + 1UL);
+}
+
+uint32_t clock_smclk_hz(void)
+{
+    return clock_mclk_hz(); // SMCLK = MCLK (DIVS = 1)
+}
+
+bool clock_register_listener(clock_listener_t listener)
+{
+    uint8_t i;
+
+    for (i = 0; i < CLOCK_MAX_LISTENERS; i++)
+    {
+        if (listeners[i] == NULL || listeners[i] == listener)
+        {
+            listeners[i] = listener;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,116 @@
+/* ========================================================================== */
+/* clock.h                                                                    */
+/* ========================================================================== */
+/**
+ * @file      clock.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Umschaltbare Taktprofile für MCLK und SMCLK.
+ *
+ * Das Modul stellt feste Taktprofile bereit. DCO und FLL werden mit REFO
+ * (32.768 Hz) als Referenz betrieben, MCLK und SMCLK laufen mit DCOCLKDIV:
+ *   - CLOCK_1MHZ  – Starttakt, geringster Stromverbrauch
+ *   - CLOCK_8MHZ  – Höchster Takt ohne FRAM Wartezyklen
+ *   - CLOCK_16MHZ – 1 FRAM Wartezyklus
+ *   - CLOCK_24MHZ – 2 FRAM Wartezyklen, Maximaltakt
+ *
+ * Beim Umschalten wird auf das Einrasten der FLL gewartet. Module mit
+ * SMCLK-abhängigen Teilern (z.B. I²C Bitrate) registrieren sich mit
+ * clock_register_listener() und werden nach jedem Wechsel benachrichtigt.
+ *
+ * ACLK (Timer, Debouncing) ist von den Profilen nicht betroffen.
+ */
+
+#ifndef CLOCK_CLOCK_H_
+#define CLOCK_CLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Maximale Anzahl registrierter Listener. */
+#define CLOCK_MAX_LISTENERS  4
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Verfügbare Taktprofile.
+ */
+typedef enum
+{
+    CLOCK_1MHZ,           /**< MCLK = SMCLK ≈ 1 MHz */
+    CLOCK_8MHZ,           /**< MCLK = SMCLK ≈ 8 MHz */
+    CLOCK_16MHZ,          /**< MCLK = SMCLK ≈ 16 MHz */
+    CLOCK_24MHZ,          /**< MCLK = SMCLK ≈ 24 MHz */
+    CLOCK_PROFILE_COUNT
+} clock_profile_t;
+
+/** @brief Profil im Leerlauf und im OFF_STATE. */
+#define CLOCK_PROFILE_IDLE   CLOCK_1MHZ
+
+/** @brief Profil während eines Sortiervorgangs. */
+#define CLOCK_PROFILE_SORT   CLOCK_24MHZ
+
+/**
+ * @brief Callback nach einem Taktwechsel.
+ *
+ * @param[in] smclk_hz Neue SMCLK-Frequenz in Hz.
+ */
+typedef void (*clock_listener_t)(uint32_t smclk_hz);
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Setzt das Leerlaufprofil als definierten Startzustand.
+ */
+void clock_init(void);
+
+/**
+ * @brief Wechselt in ein Taktprofil.
+ *
+ * FRAM Wartezyklen werden vor dem Hochtakten erhöht und nach dem
+ * Heruntertakten verringert. Danach werden alle Listener aufgerufen.
+ * Darf nicht während einer laufenden I²C-Transaktion aufgerufen werden.
+ *
+ * @param[in] profile Gewünschtes Profil.
+ */
+void clock_set_profile(clock_profile_t profile);
+
+/**
+ * @brief Liefert das aktive Taktprofil.
+ *
+ * @return Aktives Profil.
+ */
+clock_profile_t clock_get_profile(void);
+
+/**
+ * @brief Liefert die aktuelle MCLK-Frequenz.
+ *
+ * @return MCLK in Hz.
+ */
+uint32_t clock_mclk_hz(void);
+
+/**
+ * @brief Liefert die aktuelle SMCLK-Frequenz.
+ *
+ * @return SMCLK in Hz.
+ */
+uint32_t clock_smclk_hz(void);
+
+/**
+ * @brief Registriert einen Callback für Taktwechsel.
+ *
+ * @param[in] listener Aufzurufende Funktion.
+ * @return false wenn bereits CLOCK_MAX_LISTENERS registriert sind.
+ */
+bool clock_register_listener(clock_listener_t listener);
+
+#endif /* CLOCK_CLOCK_H_ */
@@ -0,0 +1,323 @@
+/* ========================================================================== */
+/* command.c                                                                  */
+/* ========================================================================== */
+/**
+ * @file      command.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der UART Befehle.
+ */
+
+#include "command.h"
+#include "uart/uart.h"
+#include "config/config.h"
+#include "trace/trace.h"
+#include "poll/poll.h"
+#include "I2C/I2C.h"
+#include "latency/latency.h"
+#include "power/power.h"
+#include "timer/timer.h"
+#include "ramfunc/ramfunc.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+extern uint16_t boot_time_ms;
+
+/** @brief Länge einer Antwortzeile inkl. Zeilenende und Nullterminierung. */
+#define REPLY_LEN 128
+
+/** @brief Empfangene Befehlszeile und Antwort, statisch wegen des kleinen Stacks. */
+static char cmd[UART_LINE_LEN + 1];
+static char line[REPLY_LEN];
+
+/**
+ * @brief Hängt " value" an eine Antwort an.
+ *
+ * @return Neues Ende der Antwort.
+ */
+static char *put_uint(char *out, uint32_t value)
+{
+    char digits[10];
+    uint8_t n = 0;
+
+    *out++ = ' ';
+    do
+    {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (n > 0)
+        *out++ = digits[--n];
+
+    return out;
+}
+
+/**
+ * @brief Liest die nächste Dezimalzahl nach mindestens einem Leerzeichen.
+ *
+ * @param[in,out] text  Lesezeiger, steht danach hinter der Zahl.
+ * @param[out]    value Gelesener Wert.
+ * @return false wenn keine Zahl folgt oder sie nicht in 16 Bit passt.
+ */
+static bool parse_uint(const char **text, uint16_t *value)
+{
+    const char *p = *text;
+    uint32_t v = 0;
+
+    if (*p != ' ')
+        return false;
+    while (*p == ' ')
+        p++;
+
+    if (*p < '0' || *p > '9')
+        return false;
+
+    while (*p >= '0' && *p <= '9')
+    {
+        v = v * 10 + (uint16_t)(*p++ - '0');
+        if (v > 0xFFFF)
+            return false;
+    }
+
+    *value = (uint16_t)v;
+    *text = p;
+    return true;
+}
+
+/**
+ * @brief Schließt die Antwort in @c line ab und sendet sie.
+ */
+static void reply(char *end)
+{
+    *end++ = '\n';
+    *end = '\0';
+    uart_write(line);
+}
+
+/**
+ * @brief Setzt ein Wort des Parameterblocks und übernimmt den Block.
+ */
+static bool set_word(uint16_t index, uint16_t value)
+{
+    config_t cfg = config;
+    uint16_t *word = (uint16_t *)&cfg;
+
+    // Version und CRC sind nicht einstellbar
+    if (index == 0 || index >= CONFIG_WORDS - 1)
+        return false;
+
+    word[index] = value;
+    cfg.crc = config_crc(&cfg);
+    return config_apply(&cfg);
+}
+
+/**
+ * @brief Sendet die Fehler- und Lastzähler aller Slaves eines Busses, je eine Zeile.
+ */
+static void send_stats(uint8_t bus_id, const I2C_bus_t *bus)
+{
+    char *end;
+    uint8_t i;
+
+    for (i = 0; i < I2C_MAX_DEVICES; i++)
+    {
+        const I2C_dev_stats_t *st = &bus->stats[i];
+
+        if (st->addr == 0)
+            continue;
+
+        line[0] = 'i';
+        end = put_uint(&line[1], bus_id);
+        end = put_uint(end, st->addr);
+        end = put_uint(end, st->nack);
+        end = put_uint(end, st->timeout);
+        end = put_uint(end, st->bus_clear);
+        end = put_uint(end, st->failed);
+        end = put_uint(end, st->transfers);
+        end = put_uint(end, st->bytes);
+        end = put_uint(end, st->busy);
+        reply(end);
+    }
+}
+
+void command_process(State_t *currentState)
+{
+    char *end = &line[1];
+    const char *arg = &cmd[1];
+    const uint16_t *word = (const uint16_t *)&config;
+    trace_entry_t entry;
+    const latency_stat_t *lat;
+    uint16_t a, b;
+    uint8_t i;
+    bool ok = true;
+
+    if (!uart_read_line(cmd))
+        return;
+
+    line[0] = cmd[0];
+
+    switch (cmd[0])
+    {
+    case 'g':
+        ok = parse_uint(&arg, &a) && a < CONFIG_WORDS;
+        if (ok)
+        {
+            end = put_uint(end, a);
+            end = put_uint(end, word[a]);
+        }
+        break;
+
+    case 's':
+        ok = parse_uint(&arg, &a) && parse_uint(&arg, &b) && set_word(a, b);
+        if (ok)
+        {
+            end = put_uint(end, a);
+            end = put_uint(end, word[a]);
+        }
+        break;
+
+    case 'l':
+        for (i = 0; i < CONFIG_WORDS; i++)
+            end = put_uint(end, word[i]);
+        break;
+
+    case 'd':
+    {
+        config_t cfg;
+
+        config_defaults(&cfg);
+        ok = config_apply(&cfg);
+        break;
+    }
+
+    case 'c':
+        end = put_uint(end, total_sorted);
+        end = put_uint(end, red_sorted);
+        end = put_uint(end, green_sorted);
+        end = put_uint(end, blue_sorted);
+        break;
+
+    case 'p':
+        end = put_uint(end, boot_time_ms);
+        end = put_uint(end, poll_period_ms());
+        end = put_uint(end, trace_count());
+        end = put_uint(end, (uint16_t)*currentState);
+        end = put_uint(end, timer_stamp32() / TIMER_STAMP_HZ);
+        break;
+
+    case 't':
+        ok = parse_uint(&arg, &a) && trace_read(a, &entry);
+        if (ok)
+        {
+            end = put_uint(end, a);
+            end = put_uint(end, entry.flags >> TRACE_FLAG_LANE_SHIFT);
+            end = put_uint(end, entry.clear);
+            end = put_uint(end, entry.red);
+            end = put_uint(end, entry.green);
+            end = put_uint(end, entry.blue);
+            end = put_uint(end, entry.color);
+            end = put_uint(end, entry.confidence);
+            end = put_uint(end, entry.bin);
+            end = put_uint(end, entry.flags);
+            end = put_uint(end, entry.t_measure_ms);
+            end = put_uint(end, entry.t_empty_ms);
+        }
+        break;
+
+    case 'i':
+        send_stats(0, &I2C_bus0);
+        send_stats(1, &I2C_bus1);
+        line[0] = 'i'; // leere Zeile schließt die Liste ab
+        break;
+
+    case 'u':
+        end = put_uint(end, I2C_utilization(&I2C_bus0));
+        end = put_uint(end, I2C_utilization(&I2C_bus1));
+        end = put_uint(end, I2C_bus0.busy);
+        end = put_uint(end, I2C_bus1.busy);
+        break;
+
+    case 'k':
+        ok = calibrate_FSM(*currentState);
+        break;
+
+    case 'v':
+        if (cmd[1] == '\0')
+        {
+            latency_reset();
+            break;
+        }
+        ok = parse_uint(&arg, &a) && parse_uint(&arg, &b) &&
+             (lat = latency_get((uint8_t)a, (uint8_t)b)) != NULL;
+        if (ok)
+        {
+            end = put_uint(end, a);
+            end = put_uint(end, b);
+            end = put_uint(end, lat->count);
+            end = put_uint(end, lat->min);
+            end = put_uint(end, lat->max);
+            for (i = 0; i < LATENCY_BUCKETS; i++)
+                end = put_uint(end, lat->hist[i]);
+        }
+        break;
+
+    case 'w':
+        if (cmd[1] == '\0')
+        {
+            end = put_uint(end, power_pills());
+            end = put_uint(end, power_energy_uj(POWER_STATES));
+            end = put_uint(end, power_pills() ? power_energy_uj(POWER_STATES) / power_pills() : 0);
+            break;
+        }
+        ok = parse_uint(&arg, &a) && a < POWER_STATES;
+        if (ok)
+        {
+            end = put_uint(end, a);
+            for (i = 0; i < POWER_MODES; i++)
+                end = put_uint(end, power_time((uint8_t)a, i));
+            end = put_uint(end, power_energy_uj((uint8_t)a));
+        }
+        break;
+
+    case 'r':
+        end = put_uint(end, RAMFUNC_ENABLE);
+        for (i = 0; i < RAMFUNC_BENCH_COUNT; i++)
+            end = put_uint(end, ramfunc_bench(i));
+        break;
+
+    case 'z':
+        power_reset();
+        break;
+
+    case 'm':
+        if (arg[0] != ' ')
+            ok = false;
+        else if (arg[1] == 'a')
+            ok = switch_mode_FSM(currentState, AUTO_SORT_STATE);
+        else if (arg[1] == 'm')
+            ok = switch_mode_FSM(currentState, MANUAL_SORT_STATE);
+        else if (arg[1] == 'o')
+            ok = switch_mode_FSM(currentState, OFF_STATE);
+        else
+            ok = false;
+
+        if (ok)
+            end = put_uint(end, (uint16_t)*currentState);
+        break;
+
+    default:
+        ok = false;
+        break;
+    }
+
+    if (!ok)
+    {
+        line[0] = 'e';
+        end = &line[1];
+    }
+
+    reply(end);
+}
@@ -0,0 +1,62 @@
+/* ========================================================================== */
+/* command.h                                                                  */
+/* ========================================================================== */
+/**
+ * @file      command.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Befehle über die UART zum Abstimmen und Auslesen im Betrieb.
+ *
+ * Eine Befehlszeile besteht aus einem Buchstaben und dezimalen Argumenten,
+ * getrennt durch Leerzeichen. Jede Zeile wird mit genau einer Zeile
+ * beantwortet (Ausnahme: @c i), die mit dem Befehlsbuchstaben beginnt;
+ * ungültige Befehle mit @c e:
+ *
+ *   | Befehl       | Antwort                                      |
+ *   |--------------|----------------------------------------------|
+ *   | g IDX        | g IDX WERT – Wort IDX des Parameterblocks    |
+ *   | s IDX WERT   | s IDX WERT – Wort setzen und übernehmen      |
+ *   | l            | l W0 W1 ... – ganzer Block inkl. Version/CRC |
+ *   | d            | d – Voreinstellungen übernehmen              |
+ *   | c            | c GESAMT ROT GRÜN BLAU                       |
+ *   | p            | p BOOT_MS PERIODE_MS TRACES STATE UPTIME_S   |
+ *   | t ALTER      | t ALTER LANE C R G B FARBE KONF AUSG FLAGS T_MESS T_LEER |
+ *   | i            | je Slave: i BUS ADR NACK TIMEOUT CLEAR FAILED |
+ *   |              | ANZAHL BYTES BELEGT, danach eine Zeile nur i |
+ *   | u            | u AUSL0 AUSL1 BELEGT0 BELEGT1 – Busauslastung |
+ *   |              | in % und Belegungszeit in Ticks (I2C.h)      |
+ *   | k            | k – Lanes neu kalibrieren                    |
+ *   | v EVT ART    | v EVT ART ANZAHL MIN MAX H0 ... H7 – Latenz  |
+ *   |              | (ART 0 = Wartezeit, 1 = Laufzeit, latency.h) |
+ *   | v            | v – Latenzstatistik zurücksetzen             |
+ *   | w            | w OBJEKTE ENERGIE_UJ UJ_JE_OBJEKT            |
+ *   | w STATE      | w STATE T_AKTIV T_LPM0 T_LPM3 ENERGIE_UJ –   |
+ *   |              | Zeiten in Ticks (power.h)                    |
+ *   | z            | z – Energiebilanz zurücksetzen               |
+ *   | r            | r RAM EVENT STAMP KLASS I2C – Zyklen         |
+ *   |              | im Sortierprofil, RAM = RAMFUNC_ENABLE       |
+ *   | m a / m m / m o | m STATE – Auto, Manuell, Aus              |
+ *
+ * Die Indizes entsprechen der Reihenfolge der Felder in config_t. Version
+ * und CRC sind nur lesbar, die CRC wird beim Setzen neu berechnet.
+ * Host-Skript: tools/uart_tune.py.
+ *
+ * Ausgeführt wird nur beim Event EVT_UART, Antworten werden ohne Warten
+ * über den Sendepuffer der UART verschickt. Nur Kalibrierung und
+ * Moduswechsel blockieren wie ihre Gegenstücke per Knopfdruck.
+ */
+
+#ifndef COMMAND_COMMAND_H_
+#define COMMAND_COMMAND_H_
+
+#include "state_machine/state_machine.h"
+
+/**
+ * @brief Führt eine empfangene Befehlszeile aus und sendet die Antwort.
+ *
+ * @param[in,out] currentState Aktueller State, Ziel von Moduswechseln.
+ */
+void command_process(State_t *currentState);
+
+#endif /* COMMAND_COMMAND_H_ */
@@ -0,0 +1,150 @@
+/* ========================================================================== */
+/* config.c                                                                   */
+/* ========================================================================== */
+/**
+ * @file      config.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der einstellbaren Betriebsparameter.
+ */
+
+#include "config.h"
+#include "fram/fram.h"
+#include "PCA9685/PCA9685.h"
+#include "platform/platform.h"
+#include "lane/lane.h"
+#include "poll/poll.h"
+#include "power/power.h"
+#include "standby/standby.h"
+#include "timer/timer.h"
+#include <msp430.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#pragma PERSISTENT(config)
+config_t config = { 0 };
+
+/**
+ * @brief Prüft, ob ein Servo-Puls im zulässigen Bereich liegt.
+ */
+static bool pulse_valid(uint16_t pulse)
+{
+    return pulse >= CONFIG_PULSE_MIN && pulse <= CONFIG_PULSE_MAX;
+}
+
+/**
+ * @brief Prüft Version, CRC und Wertebereiche eines Blocks.
+ */
+static bool valid(const config_t *cfg)
+{
+    if (cfg->version != CONFIG_VERSION || cfg->crc != config_crc(cfg))
+        return false;
+
+    if (cfg->aim_ms > CONFIG_DWELL_MAX_MS || cfg->empty_ms > CONFIG_DWELL_MAX_MS ||
+        cfg->level_ms > CONFIG_DWELL_MAX_MS || cfg->empty_min_ms > cfg->empty_ms)
+        return false;
+
+    if (!pulse_valid(cfg->pulse_red) || !pulse_valid(cfg->pulse_green) ||
+        !pulse_valid(cfg->pulse_blue) || !pulse_valid(cfg->pulse_reject) ||
+        !pulse_valid(cfg->pulse_level) || !pulse_valid(cfg->pulse_tilt) ||
+        !pulse_valid(cfg->pulse_sleep))
+        return false;
+
+    if (cfg->detect_pct == 0 || cfg->detect_pct > 100 ||
+        cfg->empty_pct == 0 || cfg->empty_pct > 100 || cfg->min_confidence > 255)
+        return false;
+
+    if (cfg->supply_mv < CONFIG_SUPPLY_MIN_MV || cfg->supply_mv > CONFIG_SUPPLY_MAX_MV)
+        return false;
+
+    return cfg->poll_fast_ms != 0 && cfg->poll_fast_ms <= cfg->poll_slow_ms &&
+           cfg->poll_slow_ms <= TIMER_SYSTICK_MAX_MS;
+}
+
+/**
+ * @brief Schreibt einen Block ins FRAM und übernimmt die Erkennungsperiode.
+ */
+static void store(const config_t *cfg)
+{
+    uint16_t wp = fram_unlock();
+
+    config = *cfg;
+
+    fram_lock(wp);
+
+    poll_set_bounds(config.poll_fast_ms, config.poll_slow_ms);
+}
+
+bool config_init(void)
+{
+    config_t defaults;
+
+    if (valid(&config))
+    {
+        poll_set_bounds(config.poll_fast_ms, config.poll_slow_ms);
+        return true;
+    }
+
+    config_defaults(&defaults);
+    store(&defaults);
+    return false;
+}
+
+void config_defaults(config_t *cfg)
+{
+    cfg->version = CONFIG_VERSION;
+
+    cfg->aim_ms = PLATFORM_AIM_MS;
+    cfg->empty_ms = PLATFORM_EMPTY_MS;
+    cfg->level_ms = PLATFORM_LEVEL_MS;
+    cfg->empty_min_ms = PLATFORM_EMPTY_MIN_MS;
+
+    cfg->pulse_red = SERVO_DEG_PULSE_50;
+    cfg->pulse_green = SERVO_DEG_PULSE_90;
+    cfg->pulse_blue = SERVO_DEG_PULSE_120;
+    cfg->pulse_reject = PLATFORM_REJECT_PULSE;
+    cfg->pulse_level = SERVO_DEG_PULSE_90;
+    cfg->pulse_tilt = SERVO_DEG_PULSE_40;
+    cfg->pulse_sleep = SERVO_DEG_PULSE_135;
+
+    cfg->detect_pct = LANE_DETECT_PCT;
+    cfg->empty_pct = LANE_DETECT_PCT;
+    cfg->min_confidence = LANE_MIN_CONFIDENCE;
+
+    cfg->poll_fast_ms = POLL_FAST_MS;
+    cfg->poll_slow_ms = POLL_SLOW_MS;
+
+    cfg->active_ua_mhz = POWER_ACTIVE_UA_MHZ;
+    cfg->lpm0_ua = POWER_LPM0_UA;
+    cfg->lpm3_ua = POWER_LPM3_UA;
+    cfg->base_ua = POWER_BASE_UA;
+    cfg->supply_mv = POWER_SUPPLY_MV;
+
+    cfg->standby_s = STANDBY_IDLE_S;
+
+    cfg->crc = config_crc(cfg);
+}
+
+uint16_t config_crc(const config_t *cfg)
+{
+    const uint8_t *byte = (const uint8_t *)cfg;
+    uint16_t i;
+
+    CRCINIRES = 0xFFFF;
+
+    // Bit-umgekehrte Eingabe ergibt die übliche MSB-first CCITT Berechnung
+    for (i = 0; i < sizeof(config_t) - sizeof(cfg->crc); i++)
+        CRCDIRB_L = byte[i];
+
+    return CRCINIRES;
+}
+
+bool config_apply(const config_t *cfg)
+{
+    if (!valid(cfg))
+        return false;
+
+    store(cfg);
+    return true;
+}
@@ -0,0 +1,160 @@
+/* ========================================================================== */
+/* config.h                                                                   */
+/* ========================================================================== */
+/**
+ * @file      config.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Einstellbare Betriebsparameter im FRAM.
+ *
+ * Zeiten, Servo-Positionen und Schwellwerte, die je Maschine abgestimmt
+ * werden, liegen als Block im FRAM und werden von den Modulen zur Laufzeit
+ * über @c config gelesen:
+ *   - Wartezeiten der Plattform (platform.h)
+ *   - Servo-Pulse der Ausgänge und der Kippbewegung
+ *   - Schwellwerte der Objekt- und Leer-Erkennung in % des Referenzwerts
+ *   - Mindestkonfidenz der Farbentscheidung
+ *   - Grenzen der Erkennungsperiode (poll.h)
+ *   - Stromaufnahme und Versorgungsspannung der Energiebilanz (power.h)
+ *   - Wartezeit bis zum Standby (standby.h)
+ *
+ * Der Block trägt eine Version und eine CRC-16-CCITT (CRC-Modul des
+ * MSP430). Stimmt eines davon beim Start nicht, gelten die Voreinstellungen.
+ * Ein neuer Block wird mit config_apply() geprüft, geschrieben und ohne
+ * Neustart übernommen.
+ *
+ * Integrationszeit und Verstärkung des Farbsensors bleiben fest, da
+ * Wartezeiten und Umrechnung der Nachmessung (lane.c) darauf abgestimmt sind.
+ */
+
+#ifndef CONFIG_CONFIG_H_
+#define CONFIG_CONFIG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Version des Layouts, wird bei jeder Änderung von config_t erhöht. */
+#define CONFIG_VERSION 3U
+
+/** @brief Kleinster zulässiger Servo-Puls (≈ 0.5 ms). */
+#define CONFIG_PULSE_MIN 100U
+
+/** @brief Größter zulässiger Servo-Puls (≈ 2.5 ms). */
+#define CONFIG_PULSE_MAX 520U
+
+/** @brief Größte zulässige Wartezeit der Plattform in ms (timer_sleep_ms()). */
+#define CONFIG_DWELL_MAX_MS 3000U
+
+/** @brief Zulässiger Bereich der Versorgungsspannung in mV. */
+#define CONFIG_SUPPLY_MIN_MV 1800U
+#define CONFIG_SUPPLY_MAX_MV 3600U
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Parameterblock.
+ *
+ * Alle Felder sind 16 Bit breit, damit der Block auch wortweise über
+ * einen Index adressiert werden kann.
+ */
+typedef struct
+{
+    uint16_t version;        /**< CONFIG_VERSION */
+
+    /* Plattform */
+    uint16_t aim_ms;         /**< Richtungsservo erreicht Position */
+    uint16_t empty_ms;       /**< Plattform gekippt, vollständig entleert */
+    uint16_t level_ms;       /**< Rückkehr in Standardposition */
+    uint16_t empty_min_ms;   /**< Kippen bis zur ersten Leer-Prüfung */
+
+    /* Servo-Pulse */
+    uint16_t pulse_red;      /**< Richtung Rot */
+    uint16_t pulse_green;    /**< Richtung Grün */
+    uint16_t pulse_blue;     /**< Richtung Blau */
+    uint16_t pulse_reject;   /**< Richtung Ausschuss */
+    uint16_t pulse_level;    /**< Kippservo waagrecht */
+    uint16_t pulse_tilt;     /**< Kippservo entleeren */
+    uint16_t pulse_sleep;    /**< Kippservo Schlafposition */
+
+    /* Erkennung */
+    uint16_t detect_pct;     /**< Mindestabweichung Objekterkennung in % */
+    uint16_t empty_pct;      /**< Mindestabweichung Leer-Prüfung in % */
+    uint16_t min_confidence; /**< Mindestkonfidenz (0-255) */
+
+    /* Erkennungsperiode */
+    uint16_t poll_fast_ms;   /**< Periode nach einem sortierten Objekt */
+    uint16_t poll_slow_ms;   /**< Periode im Leerlauf */
+
+    /* Energiebilanz */
+    uint16_t active_ua_mhz;  /**< Aktivstrom in µA je MHz MCLK */
+    uint16_t lpm0_ua;        /**< Strom im LPM0 in µA */
+    uint16_t lpm3_ua;        /**< Strom im LPM3 in µA */
+    uint16_t base_ua;        /**< Grundlast der übrigen Baugruppen in µA */
+    uint16_t supply_mv;      /**< Versorgungsspannung in mV */
+
+    /* Standby */
+    uint16_t standby_s;      /**< Ruhezeit in OFF_STATE bis zum Standby in s, 0 = nie */
+
+    uint16_t crc;            /**< CRC-16-CCITT über alle vorherigen Felder */
+} config_t;
+
+/** @brief Anzahl der 16 Bit Worte eines Blocks inklusive CRC. */
+#define CONFIG_WORDS (sizeof(config_t) / sizeof(uint16_t))
+
+/**
+ * @brief Aktiver Parameterblock im FRAM.
+ *
+ * Nur lesen, geschrieben wird ausschließlich über config_apply().
+ */
+extern config_t config;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Prüft den Block im FRAM und stellt bei Fehlern die
+ *        Voreinstellungen her.
+ *
+ * @return true wenn der gespeicherte Block gültig war.
+ */
+bool config_init(void);
+
+/**
+ * @brief Füllt einen Block mit den Voreinstellungen (inkl. Version und CRC).
+ *
+ * @param[out] cfg Block.
+ */
+void config_defaults(config_t *cfg);
+
+/**
+ * @brief Berechnet die CRC eines Blocks (ohne das Feld crc).
+ *
+ * @param[in] cfg Block.
+ * Die Bytes werden in Speicherreihenfolge (Little Endian) verarbeitet,
+ * das Ergebnis entspricht CRC-16/CCITT-FALSE über das Speicherabbild.
+ *
+ * @return CRC-16-CCITT, Startwert 0xFFFF.
+ */
+uint16_t config_crc(const config_t *cfg);
+
+/**
+ * @brief Prüft einen neuen Block, schreibt ihn ins FRAM und übernimmt ihn.
+ *
+ * Geprüft werden Version, CRC und Wertebereiche. Zeiten und Pulse wirken ab
+ * der nächsten Verwendung, die Grenzen der Erkennungsperiode sofort.
+ * Geänderte Prozent-Schwellwerte gelten ab der nächsten Kalibrierung.
+ *
+ * @param[in] cfg Neuer Block.
+ * @return true wenn der Block übernommen wurde.
+ */
+bool config_apply(const config_t *cfg);
+
+#endif /* CONFIG_CONFIG_H_ */
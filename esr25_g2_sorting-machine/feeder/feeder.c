@@ -0,0 +1,86 @@
+/* ========================================================================== */
+/* feeder.c                                                                   */
+/* ========================================================================== */
+/**
+ * @file      feeder.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der Zuführung.
+ */
+
+#include "feeder.h"
+#include "PCA9685/PCA9685.h"
+#include <stddef.h>
+
+const feeder_pattern_t FEEDER_PATTERN_GATE = {
+    SERVO_DEG_PULSE_90, SERVO_DEG_PULSE_40, 0, 0
+};
+
+const feeder_pattern_t FEEDER_PATTERN_VIBRATION = {
+    2048, 0, 150, 350
+};
+
+/**
+ * @brief Führt das Pulsmuster aus, solange die Zuführung offen ist.
+ *
+ * @param[in] ctx Zuführung.
+ */
+static PT_THREAD(feeder_thread(pt_t *pt, void *ctx))
+{
+    feeder_t *feeder = (feeder_t *)ctx;
+
+    PT_BEGIN(pt);
+
+    while (true)
+    {
+        PCA9685_set_servo_position(feeder->channel, feeder->pattern->open_pulse);
+
+        // Dauerhaft offen, der Task wird nicht mehr gebraucht
+        if (feeder->pattern->open_ms == 0)
+            PT_EXIT(pt);
+
+        PT_WAIT_MS(pt, feeder->pattern->open_ms);
+
+        PCA9685_set_servo_position(feeder->channel, feeder->pattern->closed_pulse);
+        PT_WAIT_MS(pt, feeder->pattern->closed_ms);
+    }
+
+    PT_END(pt);
+}
+
+void feeder_init(feeder_t *feeder)
+{
+    feeder->open = false;
+    PCA9685_set_servo_position(feeder->channel, feeder->pattern->closed_pulse);
+}
+
+void feeder_open(feeder_t *feeder)
+{
+    if (feeder->open)
+        return;
+
+    feeder->open = true;
+    pt_task_start(&feeder->task, feeder_thread, feeder);
+}
+
+void feeder_close(feeder_t *feeder)
+{
+    pt_task_stop(&feeder->task);
+    feeder->open = false;
+
+    PCA9685_set_servo_position(feeder->channel, feeder->pattern->closed_pulse);
+}
+
+void feeder_set_pattern(feeder_t *feeder, const feeder_pattern_t *pattern)
+{
+    feeder->pattern = pattern;
+
+    if (feeder->open)
+        pt_task_start(&feeder->task, feeder_thread, feeder);
+}
+
+bool feeder_is_open(const feeder_t *feeder)
+{
+    return feeder->open;
+}
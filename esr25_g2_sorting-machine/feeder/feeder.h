@@ -0,0 +1,122 @@
+/* ========================================================================== */
+/* feeder.h                                                                   */
+/* ========================================================================== */
+/**
+ * @file      feeder.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Zuführung der Objekte über einen freien PCA9685 Kanal.
+ *
+ * Jede Lane hat eine Zuführung (Schieber-Servo oder Vibrationsmotor) an
+ * einem freien Kanal des PCA9685:
+ *   - Lane 0: Kanal 1
+ *   - Lane 1: Kanal 9
+ *
+ * Die Zuführung ist nur offen, solange die Plattform leer in der
+ * Standardposition steht. Die Lane schließt sie, sobald ein Objekt erkannt
+ * wird, und öffnet sie erst wieder, wenn die Plattform nach dem Entleeren
+ * zurück ist. So landet kein Objekt auf einer kippenden Plattform.
+ *
+ * Das Verhalten im offenen Zustand beschreibt ein Pulsmuster:
+ *   - open_ms = 0: Ausgang bleibt auf open_pulse (Schieber offen)
+ *   - open_ms > 0: open_pulse für open_ms, dann closed_pulse für closed_ms,
+ *     wiederholt bis zum Schließen (dosierte Zuführung)
+ *
+ * Pulsmuster laufen als Task des Schedulers (siehe pt.h).
+ */
+
+#ifndef FEEDER_FEEDER_H_
+#define FEEDER_FEEDER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pt/pt.h"
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+#define FEEDER_CHANNEL_0 1 /**< PCA9685 Kanal der Zuführung, Lane 0 */
+#define FEEDER_CHANNEL_1 9 /**< PCA9685 Kanal der Zuführung, Lane 1 */
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Pulsmuster einer Zuführung.
+ */
+typedef struct
+{
+    uint16_t open_pulse;   /**< PCA9685 Wert für offen bzw. Motor an (0-4095) */
+    uint16_t closed_pulse; /**< PCA9685 Wert für geschlossen bzw. Motor aus */
+    uint16_t open_ms;      /**< Dauer eines Pulses, 0 = dauerhaft offen */
+    uint16_t closed_ms;    /**< Pause zwischen zwei Pulsen */
+} feeder_pattern_t;
+
+/**
+ * @brief Zuführung einer Lane.
+ */
+typedef struct
+{
+    uint8_t                 channel; /**< PCA9685 Kanal */
+    const feeder_pattern_t *pattern; /**< Aktuelles Pulsmuster */
+    pt_task_t               task;    /**< Task des Pulsmusters */
+    bool                    open;    /**< Zuführung ist freigegeben */
+} feeder_t;
+
+/** @brief Schieber-Servo: 90° offen, 40° geschlossen, dauerhaft offen. */
+extern const feeder_pattern_t FEEDER_PATTERN_GATE;
+
+/** @brief Vibrationsmotor: 50 % Tastgrad, 150 ms an, 350 ms Pause. */
+extern const feeder_pattern_t FEEDER_PATTERN_VIBRATION;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Schließt die Zuführung.
+ *
+ * Muss einmal nach PCA9685_init() aufgerufen werden.
+ *
+ * @param[in,out] feeder Zuführung.
+ */
+void feeder_init(feeder_t *feeder);
+
+/**
+ * @brief Gibt die Zuführung frei und startet das Pulsmuster.
+ *
+ * Eine bereits offene Zuführung bleibt unverändert.
+ *
+ * @param[in,out] feeder Zuführung.
+ */
+void feeder_open(feeder_t *feeder);
+
+/**
+ * @brief Schließt die Zuführung sofort.
+ *
+ * @param[in,out] feeder Zuführung.
+ */
+void feeder_close(feeder_t *feeder);
+
+/**
+ * @brief Wechselt das Pulsmuster.
+ *
+ * Eine offene Zuführung übernimmt das neue Muster sofort.
+ *
+ * @param[in,out] feeder  Zuführung.
+ * @param[in]     pattern Pulsmuster, muss dauerhaft gültig bleiben.
+ */
+void feeder_set_pattern(feeder_t *feeder, const feeder_pattern_t *pattern);
+
+/**
+ * @brief Prüft, ob die Zuführung freigegeben ist.
+ *
+ * @param[in] feeder Zuführung.
+ * @return true zwischen feeder_open() und feeder_close().
+ */
+bool feeder_is_open(const feeder_t *feeder);
+
+#endif /* FEEDER_FEEDER_H_ */
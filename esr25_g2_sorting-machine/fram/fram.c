@@ -0,0 +1,26 @@
+/* ========================================================================== */
+/* fram.c                                                                     */
+/* ========================================================================== */
+/**
+ * @file      fram.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung des FRAM Schreibzugriffs.
+ */
+
+#include "fram.h"
+#include <msp430.h>
+
+uint16_t fram_unlock(void)
+{
+    uint16_t state = SYSCFG0 & (PFWP | DFWP);
+
+    SYSCFG0 = FRWPPW | (state & ~PFWP); // Programm-FRAM beschreibbar
+    return state;
+}
+
+void fram_lock(uint16_t state)
+{
+    SYSCFG0 = FRWPPW | state;
+}
@@ -0,0 +1,41 @@
+/* ========================================================================== */
+/* fram.h                                                                     */
+/* ========================================================================== */
+/**
+ * @file      fram.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Schreibzugriff auf persistente Variablen im FRAM.
+ *
+ * Der Programm-FRAM des MSP430FR2355 ist über SYSCFG0.PFWP schreibgeschützt.
+ * Variablen mit `#pragma PERSISTENT` liegen im FRAM und dürfen nur zwischen
+ * fram_unlock() und fram_lock() beschrieben werden:
+ *
+ * @code
+ * uint16_t wp = fram_unlock();
+ * persistent_var = 42;
+ * fram_lock(wp);
+ * @endcode
+ */
+
+#ifndef FRAM_FRAM_H_
+#define FRAM_FRAM_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Hebt den Schreibschutz des Programm-FRAM auf.
+ *
+ * @return Vorheriger Zustand der Schutzbits für fram_lock().
+ */
+uint16_t fram_unlock(void);
+
+/**
+ * @brief Stellt den Schreibschutz des Programm-FRAM wieder her.
+ *
+ * @param[in] state Rückgabewert des zugehörigen fram_unlock() Aufrufs.
+ */
+void fram_lock(uint16_t state);
+
+#endif /* FRAM_FRAM_H_ */
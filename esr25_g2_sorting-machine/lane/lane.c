@@ -0,0 +1,497 @@
+/* ========================================================================== */
+/* lane.c                                                                     */
+/* ========================================================================== */
+/**
+ * @file      lane.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der Sortierspuren.
+ */
+
+#include "lane.h"
+#include "timer/timer.h"
+#include "config/config.h"
+#include "ramfunc/ramfunc.h"
+#include "I2C/I2C.h"
+#include <msp430.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Umrechnung einer Nachmessung (24 ms, 16x) auf die erste Messung (100 ms, 4x). */
+#define RESAMPLE_NUM ((uint32_t)(256 - TCS34725_ATIME_100MS) * 4)
+#define RESAMPLE_DEN ((uint32_t)(256 - TCS34725_ATIME_24MS) * 16)
+
+lane_t lanes[LANE_COUNT] = {
+    { 0, &TCS_sensor0, { RICHTUNGSSERVO_0, KIPPSERVO_0 }, true,
+      { FEEDER_CHANNEL_0, &FEEDER_PATTERN_GATE } },
+    { 1, &TCS_sensor1, { RICHTUNGSSERVO_1, KIPPSERVO_1 }, true,
+      { FEEDER_CHANNEL_1, &FEEDER_PATTERN_GATE } },
+};
+
+/**
+ * @brief Zeit seit Beginn des Kippens hat die Obergrenze erreicht.
+ */
+static bool tilt_expired(const lane_t *lane)
+{
+    return timer_stamp_to_ms(timer_stamp() - lane->t_tilt) >= config.empty_ms;
+}
+
+/**
+ * @brief Berechnet die Konfidenz der Farbentscheidung.
+ *
+ * Die Konfidenz ist der Abstand zwischen dominantem und zweitstärkstem
+ * Kanal relativ zum dominanten Kanal, skaliert auf 0-255.
+ *
+ * @param[in] r 8-Bit Rot-Wert
+ * @param[in] g 8-Bit Grün-Wert
+ * @param[in] b 8-Bit Blau-Wert
+ * @return Konfidenz (0 = keine Unterscheidung möglich)
+ */
+static RAMFUNC uint8_t color_confidence(uint8_t r, uint8_t g, uint8_t b)
+{
+    uint8_t max = r, second = g;
+
+    if (g > r)
+    {
+        max = g;
+        second = r;
+    }
+    if (b > max)
+    {
+        second = max;
+        max = b;
+    }
+    else if (b > second)
+    {
+        second = b;
+    }
+
+    if (max == 0)
+        return 0;
+
+    return (uint8_t)(((uint16_t)(max - second) * 255U) / max);
+}
+
+/**
+ * @brief Bestimmt Farbe und Konfidenz aus den Messwerten im Trace-Eintrag.
+ */
+static RAMFUNC void decide(lane_t *lane)
+{
+    trace_entry_t *entry = &lane->entry;
+    uint8_t r, g, b;
+
+    TCS_scale_rgb(entry->clear, entry->red, entry->green, entry->blue, &r, &g, &b);
+
+    if (r > g && r > b)
+        entry->color = RED;
+    else if (g > b)
+        entry->color = GREEN;
+    else
+        entry->color = BLUE;
+
+    entry->confidence = color_confidence(r, g, b);
+}
+
+/**
+ * @brief Nimmt die kompensierte Messung in die Fusion auf und entscheidet neu.
+ *
+ * Die Messwerte im Trace-Eintrag sind der Mittelwert aller Messungen des
+ * Objekts.
+ */
+static void fuse(lane_t *lane)
+{
+    trace_entry_t *entry = &lane->entry;
+
+    lane->sum[0] += lane->comp.c;
+    lane->sum[1] += lane->comp.r;
+    lane->sum[2] += lane->comp.g;
+    lane->sum[3] += lane->comp.b;
+    lane->samples++;
+
+    entry->clear = (uint16_t)(lane->sum[0] / lane->samples);
+    entry->red = (uint16_t)(lane->sum[1] / lane->samples);
+    entry->green = (uint16_t)(lane->sum[2] / lane->samples);
+    entry->blue = (uint16_t)(lane->sum[3] / lane->samples);
+
+    decide(lane);
+}
+
+/**
+ * @brief Rechnet eine Nachmessung auf Integrationszeit und Verstärkung der ersten Messung um.
+ */
+static uint16_t resample_scale(uint16_t value)
+{
+    uint32_t scaled = ((uint32_t)value * RESAMPLE_NUM) / RESAMPLE_DEN;
+
+    return (scaled > 0xFFFFU) ? 0xFFFFU : (uint16_t)scaled;
+}
+
+/**
+ * @brief Legt die Farbentscheidung fest und beginnt das Entleeren.
+ *
+ * Richtet die Plattform auf den Ausgang der erkannten Farbe aus, bei
+ * @p reject auf den Ausschuss.
+ *
+ * @return Wartezeit in ms bis der Richtungsservo steht.
+ */
+static uint16_t route(lane_t *lane, bool reject)
+{
+    trace_entry_t *entry = &lane->entry;
+    uint16_t wait_ms;
+
+    if (reject)
+        entry->color = UNKNOWN;
+
+    entry->bin = entry->color;
+    entry->flags = TRACE_FLAG_LANE(lane->id) | (lane->manual ? TRACE_FLAG_MANUAL : 0);
+
+    plattform_learn(&lane->platform, (COLOR)entry->color);
+    wait_ms = plattform_aim(&lane->platform, (COLOR)entry->color);
+
+    // Richtungsservo stand bereits auf der vorhergesagten Farbe
+    if (wait_ms < config.aim_ms)
+        entry->flags |= TRACE_FLAG_PREDICTED;
+
+    return wait_ms;
+}
+
+/**
+ * @brief Wechselt den Abschnitt und meldet Erkennung und Messung am Bus an.
+ *
+ * Während DETECT und MEASURE stellt das LCD seine Übertragungen auf dem Bus
+ * des Sensors zurück (I2C_hold()), damit die Messung nicht hinter
+ * Display-Verkehr wartet.
+ *
+ * @param[in,out] lane  Lane.
+ * @param[in]     phase Neuer Abschnitt.
+ */
+static void set_phase(lane_t *lane, lane_phase_t phase)
+{
+    bool was = (lane->phase == LANE_DETECT || lane->phase == LANE_MEASURE);
+    bool now = (phase == LANE_DETECT || phase == LANE_MEASURE);
+
+    lane->phase = phase;
+
+    if (now && !was)
+    {
+        I2C_hold(lane->sensor->dev.bus);
+    }
+    else if (was && !now)
+    {
+        // Wartende Übertragungen des LCD wieder anstoßen
+        I2C_release(lane->sensor->dev.bus);
+        pt_notify();
+    }
+}
+
+/**
+ * @brief Ablauf einer Lane von der Objekterkennung bis zum Entleeren.
+ *
+ * @param[in] ctx Lane.
+ */
+static PT_THREAD(lane_thread(pt_t *pt, void *ctx))
+{
+    lane_t *lane = (lane_t *)ctx;
+    trace_entry_t *entry = &lane->entry;
+    uint16_t clear;
+
+    PT_BEGIN(pt);
+
+    set_phase(lane, LANE_DETECT);
+    PT_SPAWN(pt, &lane->child,
+             TCS_measure(&lane->child, lane->sensor, false, TCS_INTEGRATION_MS));
+
+    // Messungen mit Busfehler werden verworfen
+    if (TCS_peek_clear(lane->sensor, &clear) != I2C_OK ||
+        clear + lane->min_delta >= lane->clear_ref)
+    {
+        TCS_power_off(lane->sensor);
+        set_phase(lane, LANE_IDLE);
+        PT_EXIT(pt);
+    }
+
+    // Objekt erkannt → keine weiteren Objekte auf die Plattform
+    feeder_close(&lane->feeder);
+
+    // Die Messung ohne LED dient als Umgebungslicht
+    lane->t_start = timer_stamp();
+    if (TCS_fetch_rgbc(lane->sensor, &lane->ambient.c, &lane->ambient.r,
+                       &lane->ambient.g, &lane->ambient.b) != I2C_OK)
+    {
+        set_phase(lane, LANE_IDLE);
+        PT_EXIT(pt);
+    }
+
+    // Farbmessung mit LED direkt im Anschluss
+    set_phase(lane, LANE_MEASURE);
+    PT_SPAWN(pt, &lane->child,
+             TCS_measure(&lane->child, lane->sensor, true, TCS_INTEGRATION_MS));
+
+    if (TCS_fetch_rgbc(lane->sensor, &lane->raw.c, &lane->raw.r,
+                       &lane->raw.g, &lane->raw.b) != I2C_OK)
+    {
+        // Ohne gültige Messung bleibt das Objekt auf der Plattform
+        set_phase(lane, LANE_IDLE);
+        PT_EXIT(pt);
+    }
+
+    TCS_subtract_ambient(&lane->raw, &lane->ambient, &lane->comp);
+    lane->sum[0] = lane->sum[1] = lane->sum[2] = lane->sum[3] = 0;
+    lane->samples = 0;
+    lane->attempts = 1;
+    fuse(lane);
+
+    if (entry->confidence < config.min_confidence)
+    {
+        // Knappe Entscheidung → kurze Nachmessungen mit höherer Verstärkung
+        TCS_configure(lane->sensor, TCS34725_ATIME_24MS, TCS34725_GAIN_16X);
+
+        while (entry->confidence < config.min_confidence &&
+               lane->attempts < LANE_MEASURE_ATTEMPTS)
+        {
+            lane->attempts++;
+            PT_SPAWN(pt, &lane->child,
+                     TCS_measure(&lane->child, lane->sensor, true,
+                                 TCS_FAST_INTEGRATION_MS));
+
+            // Nachmessungen mit Busfehler werden übersprungen
+            if (TCS_fetch_rgbc(lane->sensor, &lane->raw.c, &lane->raw.r,
+                               &lane->raw.g, &lane->raw.b) == I2C_OK)
+            {
+                lane->raw.c = resample_scale(lane->raw.c);
+                lane->raw.r = resample_scale(lane->raw.r);
+                lane->raw.g = resample_scale(lane->raw.g);
+                lane->raw.b = resample_scale(lane->raw.b);
+                TCS_subtract_ambient(&lane->raw, &lane->ambient, &lane->comp);
+                fuse(lane);
+            }
+        }
+
+        TCS_configure(lane->sensor, TCS34725_ATIME_100MS, TCS34725_GAIN_4X);
+    }
+    lane->t_measured = timer_stamp();
+
+    set_phase(lane, LANE_EMPTY);
+    lane->wait_ms = route(lane, entry->confidence < config.min_confidence);
+    lane->results |= LANE_RESULT_SORTING;
+    lane->retries = 0;
+
+    while (true)
+    {
+        PT_WAIT_MS(pt, lane->wait_ms);
+        plattform_tilt(&lane->platform);
+        lane->t_tilt = timer_stamp();
+
+        if (!lane->closed_loop)
+        {
+            // Feste Zeit, Plattform gilt danach als leer
+            PT_WAIT_MS(pt, config.empty_ms);
+            lane->empty = true;
+        }
+        else
+        {
+            // Leer-Prüfung mit kurzer Integration ohne LED
+            PT_WAIT_MS(pt, config.empty_min_ms);
+            TCS_configure(lane->sensor, TCS34725_ATIME_24MS, TCS34725_GAIN_4X);
+            lane->empty = false;
+
+            while (!tilt_expired(lane))
+            {
+                PT_SPAWN(pt, &lane->child,
+                         TCS_measure(&lane->child, lane->sensor, false,
+                                     TCS_FAST_INTEGRATION_MS));
+
+                // Busfehler zählen als "noch belegt", die Obergrenze greift trotzdem
+                if (TCS_fetch_clear(lane->sensor, &clear) == I2C_OK &&
+                    clear + lane->empty_delta >= lane->empty_ref)
+                {
+                    lane->empty = true;
+                    break;
+                }
+                PT_WAIT_MS(pt, LANE_EMPTY_POLL_MS);
+            }
+        }
+
+        // Plattform kehrt waagrecht auf die vorhergesagte Farbe zurück
+        plattform_park(&lane->platform);
+
+        if (lane->empty || lane->retries >= LANE_EMPTY_RETRIES)
+            break;
+
+        // Objekt liegt noch auf der Plattform → erneut kippen
+        lane->retries++;
+        entry->flags |= TRACE_FLAG_RETRY;
+        PT_WAIT_MS(pt, config.level_ms);
+        lane->wait_ms = plattform_aim(&lane->platform, (COLOR)entry->color);
+    }
+
+    if (!lane->empty)
+        entry->flags |= TRACE_FLAG_STUCK;
+
+    // Integrationszeit für die nächste Objekterkennung zurücksetzen
+    if (lane->closed_loop)
+        TCS_configure(lane->sensor, TCS34725_ATIME_100MS, TCS34725_GAIN_4X);
+
+    PT_WAIT_MS(pt, config.level_ms);
+
+    entry->t_measure_ms = timer_stamp_to_ms(lane->t_measured - lane->t_start);
+    entry->t_empty_ms = timer_stamp_to_ms(timer_stamp() - lane->t_measured);
+    trace_append(entry);
+
+    // Plattform leer in Standardposition → nächstes Objekt zuführen
+    if (lane->empty)
+        feeder_open(&lane->feeder);
+
+    set_phase(lane, LANE_IDLE);
+    lane->results |= LANE_RESULT_DONE;
+
+    PT_END(pt);
+}
+
+void lane_init(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        plattform_init(&lanes[i].platform);
+        feeder_init(&lanes[i].feeder);
+    }
+}
+
+void lane_resume_all(const uint8_t aimed[LANE_COUNT])
+{
+    bool settled = true;
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        plattform_resume(&lanes[i].platform, aimed[i]);
+        feeder_init(&lanes[i].feeder);
+
+        if (aimed[i] > UNKNOWN) // Position unbekannt
+            settled = false;
+    }
+
+    if (!settled)
+        timer_sleep_ms(config.level_ms);
+}
+
+bool lane_calibrate_all(void)
+{
+    bool ok = true;
+    uint16_t c;
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        if (!TCS_present(lanes[i].sensor))
+            continue;
+
+        // Bei Busfehler bleibt die bisherige Referenz erhalten
+        if (TCS_read_clear(lanes[i].sensor, &c) != I2C_OK || c == 0)
+        {
+            TCS_power_off(lanes[i].sensor);
+            ok = false;
+            continue;
+        }
+
+        lanes[i].clear_ref = c;
+        lanes[i].min_delta = (uint16_t)(((uint32_t)c * config.detect_pct) / 100);
+
+        // Clear-Wert wächst linear mit der Anzahl der Integrationszyklen
+        lanes[i].empty_ref = (uint16_t)(((uint32_t)c * (256 - TCS34725_ATIME_24MS)) /
+                                        (256 - TCS34725_ATIME_100MS));
+        lanes[i].empty_delta = (uint16_t)(((uint32_t)lanes[i].empty_ref * config.empty_pct) /
+                                          100);
+    }
+
+    return ok;
+}
+
+void lane_level_all(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+        plattform_level(&lanes[i].platform);
+
+    timer_sleep_ms(config.level_ms);
+}
+
+void lane_sleep_all(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+        plattform_sleep_position(&lanes[i].platform);
+}
+
+void lane_feed_all(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        if (lane_available(&lanes[i]) && !pt_task_running(&lanes[i].task))
+            feeder_open(&lanes[i].feeder);
+    }
+}
+
+void lane_start_all(bool manual)
+{
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        if (!lane_available(&lanes[i]) || pt_task_running(&lanes[i].task))
+            continue;
+
+        lanes[i].manual = manual;
+        set_phase(&lanes[i], LANE_DETECT);
+        pt_task_start(&lanes[i].task, lane_thread, &lanes[i]);
+    }
+}
+
+void lane_abort_all(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        feeder_close(&lanes[i].feeder);
+
+        if (!pt_task_running(&lanes[i].task))
+            continue;
+
+        pt_task_stop(&lanes[i].task);
+        TCS_power_off(lanes[i].sensor);
+        TCS_configure(lanes[i].sensor, TCS34725_ATIME_100MS, TCS34725_GAIN_4X);
+        set_phase(&lanes[i], LANE_IDLE);
+        lanes[i].results = 0;
+    }
+}
+
+bool lane_available(const lane_t *lane)
+{
+    return TCS_present(lane->sensor) && lane->clear_ref != 0;
+}
+
+bool lane_busy(const lane_t *lane)
+{
+    return pt_task_running(&lane->task);
+}
+
+uint8_t lane_take_results(lane_t *lane)
+{
+    uint8_t results = lane->results;
+
+    lane->results = 0;
+    return results;
+}
+
+bool lane_sorting(const lane_t *lane)
+{
+    return lane->phase >= LANE_MEASURE;
+}
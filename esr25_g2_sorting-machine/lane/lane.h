@@ -0,0 +1,271 @@
+/* ========================================================================== */
+/* lane.h                                                                     */
+/* ========================================================================== */
+/**
+ * @file      lane.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Sortierspuren (Lanes) mit nicht blockierendem Ablauf.
+ *
+ * Eine Lane fasst einen Farbsensor und eine Kippplatform zusammen. Beide
+ * Lanes teilen sich den Controller und den PCA9685:
+ *   - Lane 0: TCS_sensor0 (I2C_bus1), Servos 0 / 4, Zuführung 1
+ *   - Lane 1: TCS_sensor1 (I2C_bus0), Servos 8 / 12, Zuführung 9
+ *
+ * Beide TCS34725 haben die feste Adresse 0x29, daher liegt der Sensor von
+ * Lane 1 auf I2C_bus0 mit PCA9685 und LCD. Damit seine Messungen nicht
+ * hinter Display-Verkehr warten, stellt das LCD seine Übertragungen zurück,
+ * solange eine Lane in DETECT oder MEASURE ist (I2C_hold()). Die Anzeige
+ * wird dadurch bei schneller Erkennungsperiode verzögert aktualisiert.
+ * Servo-Befehle an den PCA9685 bleiben unberührt.
+ *
+ * Der Ablauf einer Lane ist ein Protothread (siehe pt.h), dessen
+ * Wartezeiten nicht blockieren:
+ *
+ *   DETECT: Messung ohne LED ─(kein Objekt)→ Ende
+ *     │     Objekt erkannt → Zuführung schließen
+ *     ▼
+ *   MEASURE: Messung mit LED, Umgebungslicht abziehen, Farbe bestimmen,
+ *            bei knapper Entscheidung nachmessen, Richtungsservo ausrichten
+ *     │
+ *     ▼
+ *   EMPTY: kippen → warten bzw. Leer-Prüfung → parken ─(noch belegt)→ kippen
+ *     │
+ *     ▼
+ *   Standardposition abwarten, Trace-Eintrag ablegen,
+ *   Zuführung öffnen (nur wenn leer) → Ende
+ *
+ * Die Messung ohne LED der Objekterkennung liefert das Umgebungslicht, die
+ * Farbmessung mit LED folgt direkt danach. Klassifiziert werden die
+ * kanalweise kompensierten Werte, damit wechselnde Raumbeleuchtung die
+ * Farbentscheidung nicht verschiebt. Die LED leuchtet nur während ihrer
+ * Integration.
+ *
+ * Liegt die Konfidenz der Farbentscheidung unter config.min_confidence, folgen
+ * kurze Nachmessungen (24 ms, 16x Verstärkung), die auf die erste Messung
+ * umgerechnet und gemittelt werden. Bleibt die Entscheidung nach
+ * LANE_MEASURE_ATTEMPTS Messungen knapp, geht das Objekt als UNKNOWN in den
+ * Ausschuss, statt in einem falschen Farbausgang zu landen.
+ *
+ * Mit geschlossener Regelung (closed_loop) prüft die Lane während des
+ * Kippens mit kurzer Integration, ob der Clear-Kanal wieder den leeren
+ * Referenzwert erreicht, und kehrt sofort in die Standardposition zurück.
+ * config.empty_ms bleibt die Obergrenze. Liegt das Objekt danach noch
+ * auf der Plattform, wird LANE_EMPTY_RETRIES mal erneut gekippt.
+ *
+ * Nach dem Entleeren parkt die Plattform auf der vorhergesagten Farbe
+ * (siehe platform.h). Stimmt die Vorhersage, wird ohne Wartezeit gekippt.
+ *
+ * Jede Lane ist ein eigener Task des Schedulers. Während eine Lane wartet,
+ * kann die andere messen oder entleeren. Was die State Machine anzeigen
+ * oder zählen muss, meldet die Lane über lane_take_results().
+ */
+
+#ifndef LANE_LANE_H_
+#define LANE_LANE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "TCS34725/TCS34725.h"
+#include "platform/platform.h"
+#include "trace/trace.h"
+#include "pt/pt.h"
+#include "feeder/feeder.h"
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Anzahl der Lanes. */
+#define LANE_COUNT 2
+
+/** @brief Wiederholungen des Kippens, wenn das Objekt liegen bleibt. */
+#define LANE_EMPTY_RETRIES 1
+
+/** @brief Voreinstellung der Mindestkonfidenz (0-255), unterhalb der nachgemessen wird. */
+#define LANE_MIN_CONFIDENCE 40
+
+/** @brief Voreinstellung der Mindestabweichung vom Clear-Referenzwert in %. */
+#define LANE_DETECT_PCT 40
+
+/** @brief Farbmessungen je Objekt, bevor es in den Ausschuss geht. */
+#define LANE_MEASURE_ATTEMPTS 3
+
+/** @brief Pause zwischen zwei Leer-Prüfungen in ms. */
+#define LANE_EMPTY_POLL_MS 20
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/** @brief Farbe erkannt, Entleeren beginnt (entry.color gültig). */
+#define LANE_RESULT_SORTING 0x01
+
+/** @brief Objekt entleert, Trace-Eintrag abgelegt. */
+#define LANE_RESULT_DONE    0x02
+
+/**
+ * @brief Abschnitt des Ablaufs einer Lane.
+ */
+typedef enum
+{
+    LANE_IDLE,    /**< Keine Aktivität */
+    LANE_DETECT,  /**< Objekterkennung über den Clear-Kanal */
+    LANE_MEASURE, /**< Farbmessung mit LED */
+    LANE_EMPTY    /**< Ausrichten, Kippen und Rückkehr der Plattform */
+} lane_phase_t;
+
+/**
+ * @brief Beschreibung und Ablaufzustand einer Lane.
+ */
+typedef struct
+{
+    /* Beschreibung */
+    uint8_t        id;          /**< Lane-Nummer (Trace) */
+    TCS_t         *sensor;      /**< Farbsensor */
+    platform_t     platform;    /**< Servos der Kippplatform */
+    bool           closed_loop; /**< Entleeren per Sensor bestätigen */
+    feeder_t       feeder;      /**< Zuführung auf die Plattform */
+
+    /* Kalibrierung */
+    uint16_t       clear_ref;   /**< Clear-Referenzwert ohne Objekt */
+    uint16_t       min_delta;   /**< Mindestabweichung zur Objekterkennung */
+    uint16_t       empty_ref;   /**< Clear-Referenzwert bei kurzer Integration */
+    uint16_t       empty_delta; /**< Mindestabweichung bei kurzer Integration */
+
+    /* Ablauf */
+    pt_task_t      task;        /**< Task des Ablaufs */
+    pt_t           child;       /**< Kind-Protothread für Sensormessungen */
+    lane_phase_t   phase;       /**< Aktueller Abschnitt */
+    uint8_t        results;     /**< Noch nicht abgeholte LANE_RESULT_* Bits */
+    uint16_t       wait_ms;     /**< Wartezeit bis der Richtungsservo steht */
+    bool           empty;       /**< Leer-Prüfung hat die Plattform leer gesehen */
+    bool           manual;      /**< Sortierung wurde per Knopfdruck ausgelöst */
+    TCS_rgbc_t     ambient;     /**< Messung ohne LED (Umgebungslicht) */
+    TCS_rgbc_t     raw;         /**< Messung mit LED, Rohwerte */
+    TCS_rgbc_t     comp;        /**< raw abzüglich ambient, Grundlage der Farbentscheidung */
+    uint32_t       sum[4];      /**< Summe der kompensierten Messungen (C, R, G, B) */
+    uint8_t        samples;     /**< Anzahl der Messungen in sum */
+    uint8_t        attempts;    /**< Anzahl der Farbmessungen inkl. Busfehler */
+    uint16_t       t_start;     /**< Zeitstempel Beginn der Farbmessung */
+    uint16_t       t_measured;  /**< Zeitstempel Ende der Farbmessung */
+    uint16_t       t_tilt;      /**< Zeitstempel Beginn des Kippens */
+    uint8_t        retries;     /**< Bereits ausgeführte Wiederholungen */
+    trace_entry_t  entry;       /**< Messwerte des aktuellen Objekts */
+} lane_t;
+
+/** @brief Alle Lanes der Maschine. */
+extern lane_t lanes[LANE_COUNT];
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Setzt die Farbvorhersage aller Plattformen zurück und fährt sie in
+ *        die Schlafposition, Zuführungen bleiben geschlossen.
+ */
+void lane_init(void);
+
+/**
+ * @brief Übernimmt nach einem Reset die gesicherten Plattformpositionen.
+ *
+ * Wie lane_init(), die Plattformen fahren aber nicht in die
+ * Schlafposition, sondern bleiben waagrecht auf ihrer gesicherten Richtung
+ * (siehe plattform_resume()). Nur wenn eine Position unbekannt ist, wird
+ * wie bei lane_level_all() auf die Standardposition gewartet.
+ *
+ * @param[in] aimed Gesicherte Richtung je Lane oder PLATFORM_AIM_NONE.
+ */
+void lane_resume_all(const uint8_t aimed[LANE_COUNT]);
+
+/**
+ * @brief Kalibriert den Clear-Referenzwert aller Lanes.
+ *
+ * Liest den derzeitigen Clear Wert jeder Lane und setzt ihn als Referenz.
+ * Der Minimum Delta Schwellwert beträgt config.detect_pct des Referenz
+ * Wertes (Leer-Prüfung: config.empty_pct). Die
+ * Referenz für die kurze Integration der Leer-Prüfung wird im Verhältnis
+ * der Integrationszeiten abgeleitet. Schlägt die Messung einer Lane fehl,
+ * behält sie ihre bisherige Referenz; ohne gültige Referenz ist sie nicht
+ * verfügbar (lane_available()).
+ *
+ * @note Blockiert für eine Messung je Lane.
+ *
+ * @return false wenn die Messung einer vorhandenen Lane fehlgeschlagen ist.
+ */
+bool lane_calibrate_all(void);
+
+/**
+ * @brief Setzt alle Plattformen in die Standardposition und wartet darauf.
+ */
+void lane_level_all(void);
+
+/**
+ * @brief Setzt alle Plattformen in die Schlafposition.
+ */
+void lane_sleep_all(void);
+
+/**
+ * @brief Öffnet die Zuführung aller freien Lanes.
+ *
+ * Die Plattformen müssen leer in der Standardposition stehen, danach
+ * steuern die Lanes ihre Zuführung selbst.
+ */
+void lane_feed_all(void);
+
+/**
+ * @brief Startet die Objekterkennung auf allen freien Lanes.
+ *
+ * Ein erkanntes Objekt wird anschließend ohne weiteren Anstoß sortiert.
+ *
+ * @param[in] manual true wenn die Sortierung per Knopfdruck ausgelöst wurde.
+ */
+void lane_start_all(bool manual);
+
+/**
+ * @brief Bricht die Abläufe aller Lanes ab.
+ *
+ * Die Tasks werden beendet, Zuführungen geschlossen, Sensoren und LEDs
+ * ausgeschaltet. Die Plattformen bleiben in ihrer aktuellen Position.
+ */
+void lane_abort_all(void);
+
+/**
+ * @brief Prüft, ob eine Lane einen Farbsensor und eine Referenz hat.
+ *
+ * Lanes ohne Sensor werden weder kalibriert noch gestartet, Lanes ohne
+ * gültige Clear-Referenz (lane_calibrate_all()) werden nicht gestartet.
+ * Ihre Zuführung bleibt geschlossen.
+ *
+ * @param[in] lane Lane.
+ * @return true wenn die Lane sortieren kann.
+ */
+bool lane_available(const lane_t *lane);
+
+/**
+ * @brief Prüft, ob der Ablauf einer Lane gerade läuft.
+ *
+ * @param[in] lane Lane.
+ * @return true von der Objekterkennung bis zum Ende des Entleerens.
+ */
+bool lane_busy(const lane_t *lane);
+
+/**
+ * @brief Holt die seit dem letzten Aufruf gemeldeten Ergebnisse ab.
+ *
+ * @param[in,out] lane Lane.
+ * @return LANE_RESULT_* Bits, 0 wenn nichts Neues vorliegt.
+ */
+uint8_t lane_take_results(lane_t *lane);
+
+/**
+ * @brief Prüft, ob eine Lane gerade ein Objekt misst oder entleert.
+ *
+ * @param[in] lane Lane.
+ * @return true ab der Farbmessung bis zum Ende des Entleerens.
+ */
+bool lane_sorting(const lane_t *lane);
+
+#endif /* LANE_LANE_H_ */
@@ -0,0 +1,104 @@
+/* ========================================================================== */
+/* latency.c                                                                  */
+/* ========================================================================== */
+/**
+ * @file      latency.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der Event-Latenzmessung.
+ */
+
+#include "latency.h"
+#include "timer/timer.h"
+#include "ramfunc/ramfunc.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/** @brief Zeitstempel des ersten noch nicht verarbeiteten Setzens je Event. */
+static volatile uint16_t posted[LATENCY_EVENTS];
+
+/** @brief Statistiken [Event][LATENCY_WAIT/LATENCY_RUN]. */
+static latency_stat_t stats[LATENCY_EVENTS][2];
+
+/** @brief Event in Verarbeitung und Zeitpunkt des Beginns. */
+static uint8_t running = LATENCY_EVENTS;
+static uint16_t t_dispatch;
+
+/**
+ * @brief Nummer des Event-Bits, LATENCY_EVENTS wenn nicht erfasst.
+ */
+static RAMFUNC uint8_t index_of(uint16_t event)
+{
+    uint8_t i;
+
+    for (i = 0; i < LATENCY_EVENTS; i++)
+    {
+        if (event == (1U << i))
+            return i;
+    }
+    return LATENCY_EVENTS;
+}
+
+/**
+ * @brief Nimmt einen Wert in eine Statistik auf.
+ */
+static void record(latency_stat_t *st, uint16_t ticks)
+{
+    uint16_t rest = ticks;
+    uint8_t bucket = 0;
+
+    while (rest >= 4 && bucket < LATENCY_BUCKETS - 1)
+    {
+        rest >>= 2;
+        bucket++;
+    }
+
+    if (st->count == 0 || ticks < st->min)
+        st->min = ticks;
+    if (ticks > st->max)
+        st->max = ticks;
+    if (st->count != 0xFFFF)
+        st->count++;
+    if (st->hist[bucket] != 0xFFFF)
+        st->hist[bucket]++;
+}
+
+RAMFUNC void latency_post(uint16_t event)
+{
+    uint8_t i = index_of(event);
+
+    if (i < LATENCY_EVENTS)
+        posted[i] = timer_stamp();
+}
+
+void latency_dispatch(uint16_t event)
+{
+    running = index_of(event);
+    t_dispatch = timer_stamp();
+
+    if (running < LATENCY_EVENTS)
+        record(&stats[running][LATENCY_WAIT], t_dispatch - posted[running]);
+}
+
+void latency_done(void)
+{
+    if (running < LATENCY_EVENTS)
+        record(&stats[running][LATENCY_RUN], timer_stamp() - t_dispatch);
+
+    running = LATENCY_EVENTS;
+}
+
+const latency_stat_t *latency_get(uint8_t index, uint8_t kind)
+{
+    if (index >= LATENCY_EVENTS || kind > LATENCY_RUN)
+        return NULL;
+
+    return &stats[index][kind];
+}
+
+void latency_reset(void)
+{
+    memset(stats, 0, sizeof(stats));
+}
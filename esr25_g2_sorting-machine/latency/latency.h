@@ -0,0 +1,100 @@
+/* ========================================================================== */
+/* latency.h                                                                  */
+/* ========================================================================== */
+/**
+ * @file      latency.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Latenz der Events vom Setzen bis zur Verarbeitung.
+ *
+ * EVENT_POST() (state_machine.h) merkt sich beim Setzen eines Events
+ * dessen Zeitstempel, sofern es nicht bereits aussteht. Die Main Loop
+ * meldet Beginn und Ende der Verarbeitung. Je Event-Bit entstehen zwei
+ * Statistiken:
+ *   - LATENCY_WAIT: vom Setzen (meist in der ISR) bis zum Aufruf des Handlers
+ *   - LATENCY_RUN:  Laufzeit des Handlers
+ *
+ * Alle Zeiten sind Ticks von timer_stamp() (1/TIMER_STAMP_HZ s). Das
+ * Histogramm ist logarithmisch, Klasse k umfasst Zeiten unter 4^(k+1)
+ * Ticks (≈ 1 ms, 4 ms, 16 ms, ... 4 s), die letzte Klasse alles darüber.
+ * So zeigt sich direkt, wie lange Knopfdrücke oder Ticks während
+ * blockierender Abschnitte warten.
+ */
+
+#ifndef LATENCY_LATENCY_H_
+#define LATENCY_LATENCY_H_
+
+#include <stdint.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Anzahl der erfassten Event-Bits (EVT_* BIT0 bis BIT4). */
+#define LATENCY_EVENTS  5
+
+/** @brief Klassen des Histogramms. */
+#define LATENCY_BUCKETS 8
+
+/** @brief Statistik vom Setzen bis zum Handler. */
+#define LATENCY_WAIT    0
+
+/** @brief Statistik der Laufzeit des Handlers. */
+#define LATENCY_RUN     1
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Statistik einer Latenz.
+ */
+typedef struct
+{
+    uint16_t count;                     /**< Anzahl Messungen (sättigt) */
+    uint16_t min;                       /**< Kleinster Wert in Ticks */
+    uint16_t max;                       /**< Größter Wert in Ticks */
+    uint16_t hist[LATENCY_BUCKETS];     /**< Logarithmisches Histogramm (sättigt) */
+} latency_stat_t;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Merkt sich den Zeitpunkt, zu dem ein Event gesetzt wurde.
+ *
+ * Wird über EVENT_POST() aufgerufen, auch aus ISRs.
+ *
+ * @param[in] event Event-Bit.
+ */
+void latency_post(uint16_t event);
+
+/**
+ * @brief Meldet den Beginn der Verarbeitung eines Events.
+ *
+ * @param[in] event Event-Bit aus getEvent().
+ */
+void latency_dispatch(uint16_t event);
+
+/**
+ * @brief Meldet das Ende der Verarbeitung des zuletzt gemeldeten Events.
+ */
+void latency_done(void);
+
+/**
+ * @brief Liefert eine Statistik.
+ *
+ * @param[in] index Nummer des Event-Bits (0 = EVT_SYSTEM_TICK).
+ * @param[in] kind  LATENCY_WAIT oder LATENCY_RUN.
+ * @return Statistik oder NULL bei ungültigem Index.
+ */
+const latency_stat_t *latency_get(uint8_t index, uint8_t kind);
+
+/**
+ * @brief Setzt alle Statistiken zurück.
+ */
+void latency_reset(void);
+
+#endif /* LATENCY_LATENCY_H_ */
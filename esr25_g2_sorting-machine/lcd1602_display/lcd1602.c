@@ -7,9 +7,12 @@
 
 #include "lcd1602.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include "timer/timer.h"
 #include "I2C/I2C.h"
-    
+#include "I2C/I2C_regcache.h"
+#include "pt/pt.h"
+
 
 #define RS 0x01
 #define RW 0x02
@@ -18,82 +21,83 @@
 #define BACKLIGHT_ON 0x08
 #define BACKLIGHT_OFF 0x00
 
+#define LCD_LINES 2
+#define LCD_COLS 16
+
 volatile static uint8_t backlight_state = 0x00;
 
+static uint8_t lcd_shadow[1];
+static uint8_t lcd_valid[1];
+
+// Schatten des PCF8574 Ausgangsports, gleiche Portwerte werden nicht erneut gesendet
+static I2C_regdev_t lcd_dev = {
+    &I2C_bus0, SLAVE_ADDRESS_LCD, 1, 0x00, 0x00, I2C_REGCACHE_PORT,
+    lcd_shadow, lcd_valid, NULL, 0, 0
+};
+
+// Zustand des Display-Tasks
+static pt_task_t lcd_task;
+static pt_t lcd_child;
+static char lcd_frame[LCD_LINES][LCD_COLS];
+static volatile bool frame_dirty = false;
+static volatile bool power_req = true;
+static volatile bool power_dirty = false;
+static bool task_active = false;
+
+// Parameter und Schleifenzähler des Tasks, bleiben über Wartepunkte erhalten
+static uint8_t send_data;
+static uint8_t send_mask;
+static uint8_t send_port;
+static uint8_t send_nibble;
+static uint8_t send_count;
+static uint8_t render_line;
+static uint8_t render_col;
+
+// Sendet ein Byte an das Display und wartet, bis es übertragen ist
+#define LCD_SEND(pt, data, cmd)                                   \
+    do {                                                          \
+        send_data = (data);                                       \
+        send_mask = (cmd) ? 0x00 : RS;                            \
+        send_count = 2;                                           \
+        PT_SPAWN((pt), &lcd_child, lcd_send(&lcd_child));         \
+    } while (0)
+
+// Sendet nur das obere Nibble (8-Bit Befehle der Initialisierung)
+#define LCD_SEND8(pt, data)                                       \
+    do {                                                          \
+        send_data = (data);                                       \
+        send_mask = 0x00;                                         \
+        send_count = 1;                                           \
+        PT_SPAWN((pt), &lcd_child, lcd_send(&lcd_child));         \
+    } while (0)
+
 
 void write8BitI2CtoDisplay(uint8_t data);
 void write4BitI2CtoDisplay(uint8_t data, bool cmd);
 extern void timer_sleep_ms(uint16_t ms);
-extern void I2C_write(uint8_t slave_addr, char *data, uint8_t length);
-
-lcd1602_res_t lcd1602_init(void) {
-    //mindestens 40ms nach Power On warten, bis mit der Initialisierung des Displays begonnen wird:
-    timer_sleep_ms(45);
-
-    //Step1 - Function set: 0 0 1 DL N F - -
-    //DataLength (DL) = 1 --> 8 Bit
-    //Num od Displ. Lines (NL) und Char Font (F) sind ndef, da mit diesem ersten 8-Bit Befehl
-    //nur D7-D4 �bertragen werden k�nnen (D3-D0 sind ja nicht angeschlossen)
-    //Data: 0011 0000
-    //CtrlNib = 0000
-    //nach Befehl mindestens 4,1 ms warten
-    write8BitI2CtoDisplay(0X30);
-    timer_sleep_ms(10);
-
-    //Step2 - Wie Step 1; mindestens 100�s warten
-    write8BitI2CtoDisplay(0X30);
-    timer_sleep_ms(1);
+static PT_THREAD(lcd_thread(pt_t *pt, void *ctx));
 
-    //Step3 - wie Step 1
-    write8BitI2CtoDisplay(0X30);
-    timer_sleep_ms(1);
-
-    //Step4 - Function Set: 0 0 1 DL N F - -
-    //Display nun auf 4 Bit Mode einstellen; dieser Befehl wird noch als
-    //8-Bit Befehl verstanden --> nur ein Aufruf; das lowLCD - Nibble ist wiederum nicht definiert
-    //Daher muss der Befehl anschlie�end im 4-Bit Mode nochmals wiederholt werden.
-    //DataLength (DL) = 0 --> 4 Bit
-    //Data: 0010 0000
-    //CtrlNib = 0000
-    write8BitI2CtoDisplay(0X20);
-    timer_sleep_ms(1);
-
-    //Step5 - Function Set: 0 0 1 DL N F - -
-    //Nun Einstellung der Anzahl der Zeilen und der Font Matrix
-    //DataLength (DL) = 0 --> 4 Bit
-    //Num. of Lines (N) = 1 --> 2 Zeilen
-    //Char Font (F) = 0 --> 5x8 Dot Matrix
-    //Data: 0010 1000
-    write4BitI2CtoDisplay(0x28, true);
-    timer_sleep_ms(1);
+bool lcd1602_probe(void) {
+    return I2C_regcache_probe(&lcd_dev);
+}
 
-    //Step6 - Display on/off: 0000 1 D C B
-    //Display ausschalten
-    //Display on/off (D) = 0 --> off
-    //Cursor on/off (C) = 0 --> off
-    //Blinking on/off (B) = 0 --> off
-    //Data: 0000 1000
-    write4BitI2CtoDisplay(0x08, true);
-    timer_sleep_ms(1);
+bool lcd1602_present(void) {
+    return I2C_regcache_present(&lcd_dev);
+}
 
-    //Step7 - Display Clear: 0000 0001
-    write4BitI2CtoDisplay(0x01, true);
-    timer_sleep_ms(5);
+lcd1602_res_t lcd1602_init(void) {
+    //ohne Display keine Wartezeiten und kein Display-Task
+    if (!lcd1602_present())
+        return eLCD1602_ok;
 
-    //Step8 - Entry mode set: 0000 01 I/D S
-    //Increment/Decrement (I/D) = 1 --> Inc
-    //Display Shift (S) = 0 --> no shift
-    //Data: 0000 0110
-    write4BitI2CtoDisplay(0x06, true);
-    timer_sleep_ms(1);
+    //Portzustand des PCF8574 nach MCU-Reset unbekannt
+    I2C_regcache_invalidate(&lcd_dev);
 
-    //Step9 - Display On/Off: 0000 1 D C B
-    //Display on/off (D) = 1 --> on
-    //Cursor on/off (C) = 0 --> off
-    //Blinking on/off (B) = 0 --> off
-    //Data: 0000 1100
-    write4BitI2CtoDisplay(0x0C, true);
-    timer_sleep_ms(1);
+    //Initialisierung läuft im Display-Task, die übrigen Geräte werden
+    //währenddessen initialisiert
+    task_active = true;
+    lcd1602_show("", "");
+    pt_task_start(&lcd_task, lcd_thread, NULL);
     return eLCD1602_ok;
 }
 
@@ -151,8 +155,7 @@ lcd1602_res_t lcd1602_backlight(bool on) {
         backlight_state = BACKLIGHT_OFF;
     }
 
-    char data[1] = {backlight_state};
-    I2C_write(SLAVE_ADDRESS_LCD, data, 1); 
+    I2C_regcache_write8(&lcd_dev, 0, backlight_state);
 
     timer_sleep_ms(1);
     return eLCD1602_ok;
@@ -167,18 +170,13 @@ bool lcd1602_getBacklightState(void) {
 void write8BitI2CtoDisplay(uint8_t data) {
     data = data|backlight_state;        
     
-    char buf[1];
-
-    buf[0] = data;
-    I2C_write(SLAVE_ADDRESS_LCD, buf, 1);
+    I2C_regcache_write8(&lcd_dev, 0, data);
     timer_sleep_ms(1);
 
-    buf[0] = data | EN;
-    I2C_write(SLAVE_ADDRESS_LCD, buf, 1);
+    I2C_regcache_write8(&lcd_dev, 0, data | EN);
     timer_sleep_ms(1);
 
-    buf[0] = data;
-    I2C_write(SLAVE_ADDRESS_LCD, buf, 1);
+    I2C_regcache_write8(&lcd_dev, 0, data);
     timer_sleep_ms(1);
 }
 
@@ -205,3 +203,181 @@ lcd1602_res_t lcd1602_display(bool on) {
     timer_sleep_ms(1);
     return eLCD1602_ok;
 }
+
+void lcd1602_show(const char* line1, const char* line2) {
+    const char* text[LCD_LINES];
+    uint8_t line;
+    uint8_t col;
+
+    if (!lcd1602_present())
+        return;
+
+    text[0] = line1;
+    text[1] = line2;
+
+    // Zeilen mit Leerzeichen auffüllen, damit kein Display Clear nötig ist
+    for (line = 0; line < LCD_LINES; line++) {
+        for (col = 0; col < LCD_COLS && text[line][col] != 0; col++)
+            lcd_frame[line][col] = text[line][col];
+        for (; col < LCD_COLS; col++)
+            lcd_frame[line][col] = ' ';
+    }
+
+    frame_dirty = true;
+    pt_signal(LCD1602_PT_EVENT);
+}
+
+void lcd1602_power(bool on) {
+    if (!lcd1602_present())
+        return;
+
+    power_req = on;
+    power_dirty = true;
+    pt_signal(LCD1602_PT_EVENT);
+}
+
+bool lcd1602_busy(void) {
+    return task_active || power_dirty || (frame_dirty && power_req);
+}
+
+// Überträgt send_count Nibble von send_data; zwischen den Portzugriffen laufen andere Tasks
+static PT_THREAD(lcd_send(pt_t *pt)) {
+    PT_BEGIN(pt);
+
+    // Messungen der Farbsensoren auf demselben Bus haben Vorrang (I2C_hold())
+    PT_WAIT_WHILE(pt, I2C_held(lcd_dev.bus));
+
+    for (send_nibble = 0; send_nibble < send_count; send_nibble++) {
+        if (send_nibble == 0)
+            send_port = (send_data & 0xF0) | send_mask | backlight_state;
+        else
+            send_port = ((send_data << 4) & 0xF0) | send_mask | backlight_state;
+
+        I2C_regcache_write8(&lcd_dev, 0, send_port);
+        PT_WAIT_MS(pt, 1);
+
+        I2C_regcache_write8(&lcd_dev, 0, send_port | EN);
+        PT_WAIT_MS(pt, 1);
+
+        I2C_regcache_write8(&lcd_dev, 0, send_port);
+        PT_WAIT_MS(pt, 1);
+    }
+
+    PT_END(pt);
+}
+
+// Display-Task: initialisiert das Display, überträgt danach Ein/Aus und
+// den zuletzt hinterlegten Inhalt
+static PT_THREAD(lcd_thread(pt_t *pt, void *ctx)) {
+    (void)ctx;
+
+    PT_BEGIN(pt);
+
+    //mindestens 40ms nach Power On warten, bis mit der Initialisierung des Displays begonnen wird:
+    PT_WAIT_MS(pt, 45);
+
+    //Step1 - Function set: 0 0 1 DL N F - -
+    //DataLength (DL) = 1 --> 8 Bit
+    //Num od Displ. Lines (NL) und Char Font (F) sind ndef, da mit diesem ersten 8-Bit Befehl
+    //nur D7-D4 �bertragen werden k�nnen (D3-D0 sind ja nicht angeschlossen)
+    //Data: 0011 0000
+    //CtrlNib = 0000
+    //nach Befehl mindestens 4,1 ms warten
+    LCD_SEND8(pt, 0x30);
+    PT_WAIT_MS(pt, 10);
+
+    //Step2 - Wie Step 1; mindestens 100�s warten
+    LCD_SEND8(pt, 0x30);
+    PT_WAIT_MS(pt, 1);
+
+    //Step3 - wie Step 1
+    LCD_SEND8(pt, 0x30);
+    PT_WAIT_MS(pt, 1);
+
+    //Step4 - Function Set: 0 0 1 DL N F - -
+    //Display nun auf 4 Bit Mode einstellen; dieser Befehl wird noch als
+    //8-Bit Befehl verstanden --> nur ein Aufruf; das lowLCD - Nibble ist wiederum nicht definiert
+    //Daher muss der Befehl anschlie�end im 4-Bit Mode nochmals wiederholt werden.
+    //DataLength (DL) = 0 --> 4 Bit
+    //Data: 0010 0000
+    //CtrlNib = 0000
+    LCD_SEND8(pt, 0x20);
+    PT_WAIT_MS(pt, 1);
+
+    //Step5 - Function Set: 0 0 1 DL N F - -
+    //Nun Einstellung der Anzahl der Zeilen und der Font Matrix
+    //DataLength (DL) = 0 --> 4 Bit
+    //Num. of Lines (N) = 1 --> 2 Zeilen
+    //Char Font (F) = 0 --> 5x8 Dot Matrix
+    //Data: 0010 1000
+    LCD_SEND(pt, 0x28, true);
+    PT_WAIT_MS(pt, 1);
+
+    //Step6 - Display on/off: 0000 1 D C B
+    //Display ausschalten
+    //Display on/off (D) = 0 --> off
+    //Cursor on/off (C) = 0 --> off
+    //Blinking on/off (B) = 0 --> off
+    //Data: 0000 1000
+    LCD_SEND(pt, 0x08, true);
+    PT_WAIT_MS(pt, 1);
+
+    //Step7 - Display Clear: 0000 0001
+    LCD_SEND(pt, 0x01, true);
+    PT_WAIT_MS(pt, 5);
+
+    //Step8 - Entry mode set: 0000 01 I/D S
+    //Increment/Decrement (I/D) = 1 --> Inc
+    //Display Shift (S) = 0 --> no shift
+    //Data: 0000 0110
+    LCD_SEND(pt, 0x06, true);
+    PT_WAIT_MS(pt, 1);
+
+    //Step9 - Display On/Off: 0000 1 D C B
+    //Display on/off (D) = 1 --> on
+    //Cursor on/off (C) = 0 --> off
+    //Blinking on/off (B) = 0 --> off
+    //Data: 0000 1100
+    LCD_SEND(pt, 0x0C, true);
+    PT_WAIT_MS(pt, 1);
+
+    task_active = false;
+
+    while (true) {
+        PT_WAIT_EVENT(pt, LCD1602_PT_EVENT);
+        task_active = true;
+
+        if (power_dirty) {
+            power_dirty = false;
+
+            if (power_req) {
+                backlight_state = BACKLIGHT_ON;
+                LCD_SEND(pt, 0x0C, true); // Display ON, Cursor OFF, Blink OFF
+            } else {
+                LCD_SEND(pt, 0x01, true); // Display Clear
+                PT_WAIT_MS(pt, 5);
+                LCD_SEND(pt, 0x08, true); // Display OFF
+                backlight_state = BACKLIGHT_OFF;
+                I2C_regcache_write8(&lcd_dev, 0, backlight_state);
+            }
+        }
+
+        // Bei ausgeschaltetem Display bleibt der Inhalt bis zum Einschalten liegen
+        if (frame_dirty && power_req) {
+            frame_dirty = false;
+
+            for (render_line = 0; render_line < LCD_LINES; render_line++) {
+                //Set DDRAM address: Zeile 1 ab 0x00, Zeile 2 ab 0x40
+                LCD_SEND(pt, render_line == 0 ? 0x80 : 0xC0, true);
+                PT_WAIT_MS(pt, 3);
+
+                for (render_col = 0; render_col < LCD_COLS; render_col++)
+                    LCD_SEND(pt, lcd_frame[render_line][render_col], false);
+            }
+        }
+
+        task_active = false;
+    }
+
+    PT_END(pt);
+}
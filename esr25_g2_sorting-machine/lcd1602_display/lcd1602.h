@@ -21,11 +21,28 @@ typedef enum {
     eLCD1602_invalidLine
 } lcd1602_res_t;
 
+// Ereignisbit des Display-Tasks für pt_signal()
+#define LCD1602_PT_EVENT 0x0001
+
+// Prüft, ob das Display antwortet; ohne Display kehren alle Funktionen sofort zurück
+bool          lcd1602_probe(void);
+bool          lcd1602_present(void);
+
+// Startet die Initialisierung im Display-Task und kehrt sofort zurück;
+// lcd1602_busy() bleibt bis zu ihrem Ende true
 lcd1602_res_t lcd1602_init(void);
+
+// Blockierende Ansteuerung, nicht zusammen mit dem Display-Task verwenden
 lcd1602_res_t lcd1602_write(uint16_t lines, char* text);
 lcd1602_res_t lcd1602_clear(void);
 lcd1602_res_t lcd1602_backlight(bool on);
 bool          lcd1602_getBacklightState(void);
 lcd1602_res_t lcd1602_display(bool on);
 
+// Nicht blockierende Ansteuerung: Inhalt bzw. Zustand wird nur hinterlegt,
+// der von lcd1602_init() gestartete Task überträgt ihn im Hintergrund
+void          lcd1602_show(const char* line1, const char* line2);
+void          lcd1602_power(bool on);
+bool          lcd1602_busy(void);
+
 #endif /* LCD1602_H_ */
@@ -28,14 +28,8 @@ void writeReady(void) {
     char ready_text1[17] = "Sortiermaschine ";
     char ready_text2[17] = "ist bereit      ";
 
-    lcd1602_clear();
-    timer_sleep_ms(5);
-    lcd1602_backlight(true);
-    timer_sleep_ms(5);
-    lcd1602_write(1, ready_text1);
-    timer_sleep_ms(5);
-    lcd1602_write(2, ready_text2);
-    timer_sleep_ms(5);
+    lcd1602_power(true);
+    lcd1602_show(ready_text1, ready_text2);
 
     return;
 }
@@ -69,12 +63,7 @@ uint8_t current_count_green, uint8_t current_count_red) {
     color_count[14] = '0' + dg;
     color_count[15] = '0' + mg;
 
-    lcd1602_clear();
-    timer_sleep_ms(5);
-    lcd1602_write(1, color_text);
-    timer_sleep_ms(5);
-    lcd1602_write(2, color_count);
-    timer_sleep_ms(5);
+    lcd1602_show(color_text, color_count);
 }
 
 void writeDetectedColor(COLOR color) {
@@ -100,22 +89,14 @@ void writeDetectedColor(COLOR color) {
         }
     }
 
-    lcd1602_clear();
-    timer_sleep_ms(5);
-    lcd1602_write(1, detected_color_text1);
-    timer_sleep_ms(5);
-    lcd1602_write(2, detected_color_text2);
-    timer_sleep_ms(5);
+    lcd1602_show(detected_color_text1, detected_color_text2);
     return;
 }
 
 void turnDisplayOn(void) {
-    lcd1602_display(true);
-    lcd1602_backlight(true);
+    lcd1602_power(true);
 }
 
 void turnDisplayOff(void) {
-    lcd1602_clear();
-    lcd1602_display(false);
-    lcd1602_backlight(false);
+    lcd1602_power(false);
 }
@@ -9,18 +9,22 @@
  * @brief     Hauptprogramm der Sortieranlage.
  *
  * Dieses Modul implementiert die Hauptfunktionalität der Sortieranlage:
- *   - Initialisierung aller Hardwaremodule
- *   - Event basierte main loop
+ *   - Initialisierung aller Hardwaremodule, das Display initialisiert sich
+ *     parallel im Hintergrund (Dauer bis bereit: boot_time_ms)
+ *   - Wiederanlauf im letzten Sortiermodus nach einem Reset (snapshot.h)
+ *   - Event basierte main loop mit Energiebilanz je State (power.h)
  *   - Watchdog und GPIO Konfiguration
+ *   - Standby in LPM4.5/LPM3.5 nach längerer Zeit in OFF_STATE (standby.h)
  */
 
 #include <msp430.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "PCA9685/PCA9685.h"
 #include "button/button.h"
-#include "platform/platform.h"
+#include "lane/lane.h"
 #include "I2C/I2C.h"
 #include "timer/timer.h"
 #include "TCS34725/TCS34725.h"
@@ -28,10 +32,47 @@
 #include "lcd1602_display/lcd1602_manager.h"
 #include "state_machine/state_machine.h"
 #include "led/led.h"
+#include "trace/trace.h"
+#include "clock/clock.h"
+#include "poll/poll.h"
+#include "presence/presence.h"
+#include "pt/pt.h"
+#include "config/config.h"
+#include "uart/uart.h"
+#include "latency/latency.h"
+#include "power/power.h"
+#include "standby/standby.h"
 
 /** @brief Global Event Bits Variable für Event Handling */
 Event_t eventBits = 0;
 
+/** @brief Dauer vom Start der Initialisierung bis alle Geräte bereit sind, in ms. */
+uint16_t boot_time_ms = 0;
+
+/** Zeitstempel zu Beginn der Initialisierung. */
+static uint16_t boot_start;
+
+/** Task, der das Ende der Initialisierung misst. */
+static pt_task_t boot_task;
+
+/**
+ * @brief Wartet auf das Ende aller im Hintergrund laufenden Initialisierungen.
+ *
+ * Das Display initialisiert sich im eigenen Task, währenddessen laufen die
+ * übrigen Geräte und die State Machine bereits.
+ */
+static PT_THREAD(boot_thread(pt_t *pt, void *ctx))
+{
+    PT_BEGIN(pt);
+
+    while (lcd1602_busy())
+        PT_WAIT_MS(pt, 1);
+
+    boot_time_ms = timer_stamp_to_ms(timer_stamp() - boot_start);
+
+    PT_END(pt);
+}
+
 /**
  * @brief Initialisiert alle GPIO Ports.
  *
@@ -66,34 +107,47 @@ void init_all_ports(void)
  * @brief Initialisiert alle Hardwaremodule der Sortieranlage.
  *
  * Führt die Initialisierung in folgender Reihenfolge durch:
- *   1. GPIO Ports (Grundkonfiguration)
- *   2. I2C Bus für Peripherie
- *   3. PCA9685 Servo Controller
- *   4. Timer für Systemtakt
+ *   1. GPIO Ports (Grundkonfiguration) und Taktprofil
+ *   2. Timer für Systemtakt (wird vom I2C Timeout benötigt),
+ *      Parameterblock im FRAM und Energiebilanz
+ *   3. I2C Bus für Peripherie
+ *   4. PCA9685 Servo Controller
  *   5. TCS34725 Farbsensor
- *   6. Buttons für Benutzereingaben
+ *   6. Buttons und UART für Benutzereingaben
  *   7. LCD1602 Display
  *   8. Status LEDs
+ *   9. Sortier-Trace im FRAM
  *
- * Konfiguriert anschließend den 1sek Systemtakt und
- * versetzt die Plattform in die Schlaf Position.
+ * Konfiguriert anschließend den Systemtakt der Objekterkennung. Die
+ * Plattformen werden erst in main() positioniert, je nachdem ob ein
+ * Sortiermodus fortgesetzt wird.
  */
 void init(void)
 {
     init_all_ports();
+    clock_init();
 
-    I2C_init();
-    PCA9685_init();
     timer_init();
-    TCS_init();
-    button_init();
+    boot_start = timer_stamp();
+    config_init();
+    power_init();
+    I2C_init(&I2C_bus0);
+    I2C_init(&I2C_bus1);
+    presence_scan();
+
+    // Display zuerst, seine Wartezeiten laufen parallel zur übrigen Initialisierung
     lcd1602_init();
+    PCA9685_init();
+    TCS_init(&TCS_sensor0);
+    TCS_init(&TCS_sensor1);
+    button_init();
+    uart_init();
     led_init();
+    trace_init();
 
-    timer_systick_init(1000);
+    timer_systick_init(config.poll_slow_ms);
 
-    plattform_sleep_position();
-    turnDisplayOff();
+    pt_task_start(&boot_task, boot_thread, NULL);
 
     __enable_interrupt();
 }
@@ -104,11 +158,14 @@ void init(void)
  *   1. Deaktiviert den Watchdog Timer
  *   2. Aktiviert die GPIOs
  *   3. Initialisiert alle Hardwaremodule
- *   4. Verarbeitet Events in main loop mit LPM3
+ *   4. Setzt einen gesicherten Sortiermodus fort oder startet in OFF_STATE,
+ *      ein Tastendruck, der aus dem Standby geweckt hat, wird nachgereicht
+ *   5. Verarbeitet Events in main loop mit LPM3
  *
  * Die Main Loop prüft kontinuierlich auf neue Events und
  * leitet diese an die State Machine weiter. In Phasen ohne
- * Events wird der Prozessor in den LPM3 versetzt.
+ * Events wird der Prozessor in den LPM3 versetzt. Wartezeit und
+ * Laufzeit jedes Events werden in latency.h erfasst.
  *
  * @return Wird nie erreicht (Endlosschleife)
  */
@@ -116,12 +173,36 @@ int main(void)
 {
     State_t currentState = OFF_STATE;
     Event_t event = EVT_NO_EVENT;
+    standby_wake_t wake;
 
     WDTCTL = WDTPW | WDTHOLD;
     PM5CTL0 &= ~LOCKLPM5;
 
+    wake = standby_wake_source();
+    if (wake == STANDBY_WAKE_RTC)
+    {
+        // Lebenszeichen ohne Initialisierung der Geräte, kehrt nicht zurück
+        init_all_ports();
+        led_init();
+        standby_heartbeat();
+    }
+
     init();
 
+    // Nach einem Reset ohne Moduswahl und Kalibrierung weitersortieren
+    if (!resume_FSM(&currentState))
+    {
+        lane_init();
+        turnDisplayOff();
+    }
+    power_set_state((uint8_t)currentState);
+    arm_standby_FSM(&currentState);
+
+    if (wake == STANDBY_WAKE_S1)
+        button_replay(EVT_S1);
+    else if (wake == STANDBY_WAKE_S2)
+        button_replay(EVT_S2);
+
     while (true)
     {
         event = getEvent(&eventBits);
@@ -129,10 +210,19 @@ int main(void)
         {
             while (event > EVT_NO_EVENT)
             {
+                latency_dispatch(event);
                 handleEvent_FSM(&currentState, event);
+                latency_done();
+                power_set_state((uint8_t)currentState);
                 event = getEvent(&eventBits);
             }
         }
-        LPM3;
+
+        // Erst mit gesperrten Interrupts prüfen, sonst geht ein Event aus
+        // einer ISR zwischen getEvent() und dem LPM verloren
+        __disable_interrupt();
+        if (eventBits == EVT_NO_EVENT)
+            power_sleep(POWER_LPM3);
+        __enable_interrupt();
     }
 }
@@ -11,51 +11,148 @@
 
 #include "PCA9685/PCA9685.h"
 #include "platform.h"
-#include "../timer/timer.h"
+#include "timer/timer.h"
+#include "config/config.h"
+#include <string.h>
 
-void plattform_default_position(void)
+/**
+ * @brief Stellt den Richtungsservo und merkt sich Richtung und Zeitpunkt.
+ */
+static void set_direction(platform_t *plat, COLOR color)
 {
-    PCA9685_set_servo_position(RICHTUNGSSERVO, SERVO_DEG_PULSE_90); 
-    PCA9685_set_servo_position(KIPPSERVO, SERVO_DEG_PULSE_90);     
+    switch (color)
+    {
+    case RED:
+        // Richtung auf Rot einstellen
+        PCA9685_set_servo_position(plat->dir_servo, config.pulse_red);
+        break;
+    case GREEN:
+        // Richtung auf Grün einstellen
+        PCA9685_set_servo_position(plat->dir_servo, config.pulse_green);
+        break;
+    case UNKNOWN:
+        // Richtung auf Ausschuss einstellen
+        PCA9685_set_servo_position(plat->dir_servo, config.pulse_reject);
+        break;
+    default:
+        // Richtung auf Blau einstellen
+        color = BLUE;
+        PCA9685_set_servo_position(plat->dir_servo, config.pulse_blue);
+        break;
+    }
 
-    timer_sleep_ms(500);
+    if (plat->aimed != color)
+    {
+        plat->aimed = color;
+        plat->t_aimed = timer_stamp32();
+    }
 }
 
-void plattform_sleep_position(void)
+/**
+ * @brief Löscht die Übergangszählung und vergisst die Richtung.
+ */
+static void reset_prediction(platform_t *plat)
 {
-    PCA9685_set_servo_position(RICHTUNGSSERVO, SERVO_DEG_PULSE_90); 
-    PCA9685_set_servo_position(KIPPSERVO, SERVO_DEG_PULSE_135);    
+    memset(plat->next, 0, sizeof(plat->next));
+    plat->last = PLATFORM_BINS;
+    plat->aimed = PLATFORM_AIM_NONE; // Position unbekannt, erste Ausrichtung wartet voll
 }
 
-void plattform_empty(void)
+void plattform_init(platform_t *plat)
 {
-    timer_sleep_ms(700); // Kurze Verzögerung vor Bewegung
+    reset_prediction(plat);
+    plattform_sleep_position(plat);
+}
 
-    // Plattform kippen zum Entleeren
-    PCA9685_set_servo_position(KIPPSERVO, SERVO_DEG_PULSE_40);
-    timer_sleep_ms(1500); // Zeit zum vollständigen Entleeren
+void plattform_resume(platform_t *plat, uint8_t aimed)
+{
+    reset_prediction(plat);
+
+    if (aimed > UNKNOWN)
+    {
+        plattform_level(plat);
+        return;
+    }
+
+    // Servo steht bereits dort, die Ausrichtung gilt als abgeschlossen
+    set_direction(plat, (COLOR)aimed);
+    plat->t_aimed = timer_stamp32() - timer_ms_to_stamp(config.aim_ms);
+    PCA9685_set_servo_position(plat->tilt_servo, config.pulse_level);
+}
+
+void plattform_level(platform_t *plat)
+{
+    set_direction(plat, GREEN);
+    PCA9685_set_servo_position(plat->tilt_servo, config.pulse_level);
+}
 
-    // Zurück zur Standardposition
-    plattform_default_position();
+void plattform_sleep_position(platform_t *plat)
+{
+    set_direction(plat, GREEN);
+    PCA9685_set_servo_position(plat->tilt_servo, config.pulse_sleep);
 }
 
-void plattform_empty_r(void)
+uint16_t plattform_aim(platform_t *plat, COLOR color)
 {
-    // Richtung auf Rot (50°) einstellen
-    PCA9685_set_servo_position(RICHTUNGSSERVO, SERVO_DEG_PULSE_50);
-    plattform_empty();
+    uint32_t elapsed;
+
+    set_direction(plat, color);
+
+    // 32 Bit, der 16 Bit Zeitstempel läuft nach 16 s Leerlauf über
+    elapsed = timer_stamp32_to_ms(timer_stamp32() - plat->t_aimed);
+    return (elapsed < config.aim_ms) ? config.aim_ms - (uint16_t)elapsed : 0;
 }
 
-void plattform_empty_g(void)
+void plattform_tilt(const platform_t *plat)
 {
-    // Richtung auf Grün (90°) einstellen
-    PCA9685_set_servo_position(RICHTUNGSSERVO, SERVO_DEG_PULSE_90);
-    plattform_empty();
+    // Plattform kippen zum Entleeren
+    PCA9685_set_servo_position(plat->tilt_servo, config.pulse_tilt);
 }
 
-void plattform_empty_b(void)
+void plattform_learn(platform_t *plat, COLOR color)
 {
-    // Richtung auf Blau (120°) einstellen
-    PCA9685_set_servo_position(RICHTUNGSSERVO, SERVO_DEG_PULSE_120);
-    plattform_empty();
+    uint8_t *row;
+    uint8_t i;
+
+    if (color >= PLATFORM_BINS)
+        return;
+
+    if (plat->last < PLATFORM_BINS)
+    {
+        row = plat->next[plat->last];
+
+        // Alte Übergänge verlieren bei vollem Zähler die Hälfte ihres Gewichts
+        if (row[color] >= PLATFORM_COUNT_MAX)
+        {
+            for (i = 0; i < PLATFORM_BINS; i++)
+                row[i] >>= 1;
+        }
+        row[color]++;
+    }
+
+    plat->last = color;
+}
+
+void plattform_park(platform_t *plat)
+{
+    COLOR predicted = (COLOR)plat->aimed;
+    uint8_t best = 0;
+    uint8_t i;
+
+    if (plat->last < PLATFORM_BINS)
+    {
+        // Wahrscheinlichster Nachfolger; ohne Übergänge die letzte Farbe
+        predicted = (COLOR)plat->last;
+        for (i = 0; i < PLATFORM_BINS; i++)
+        {
+            if (plat->next[plat->last][i] > best)
+            {
+                best = plat->next[plat->last][i];
+                predicted = (COLOR)i;
+            }
+        }
+    }
+
+    set_direction(plat, predicted);
+    PCA9685_set_servo_position(plat->tilt_servo, config.pulse_level);
 }
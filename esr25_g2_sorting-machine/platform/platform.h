@@ -8,66 +8,157 @@
  *
  * @brief     Plattform-Steuerung für automatische Sortiermaschine.
  *
- * Dieses Modul steuert die Kippplatform, die Objekte
- * basierend auf ihrer Farbe in verschiedene Richtungen entleert. Die
- * Plattform verwendet zwei Servos:
- *   - Servo 0: Richtungssteuerung (45°=Rot, 90°=Grün, 135°=Blau)
- *   - Servo 4: Kippbewegung zum Entleeren der Plattform
+ * Dieses Modul steuert die Kippplatformen, die Objekte
+ * basierend auf ihrer Farbe in verschiedene Richtungen entleeren. Jede
+ * Plattform verwendet zwei Servos am gemeinsamen PCA9685:
+ *   - Richtungsservo: Richtungssteuerung (50°=Rot, 90°=Grün, 120°=Blau,
+ *     135°=Ausschuss für Objekte ohne sichere Farbe)
+ *   - Kippservo: Kippbewegung zum Entleeren der Plattform
  *
  * Verfügbare Funktionen:
- *   - plattform_default_position() – Standardposition (beide Servos 90°)
- *   - plattform_empty_r/g/b()      – Entleeren in Rot/Grün/Blau-Richtung
- *   - plattform_empty()            – Kippbewegung zum Entleeren
+ *   - plattform_init()           – Vorhersage zurücksetzen, Schlafposition
+ *   - plattform_resume()         – Vorhersage zurücksetzen, gesicherte Position
+ *   - plattform_level()          – Standardposition (beide Servos 90°)
+ *   - plattform_sleep_position() – Schlafposition
+ *   - plattform_aim()            – Richtung für eine Farbe einstellen
+ *   - plattform_tilt()           – Kippbewegung zum Entleeren
+ *   - plattform_learn()          – Sortierte Farbe in die Vorhersage aufnehmen
+ *   - plattform_park()           – Waagrecht, Richtung auf vorhergesagte Farbe
  *
- * @note Dieses Modul benötigt den PCA9685 PWM Treiber und Timer Modul.
+ * Die Funktionen warten nicht auf die Servos. Ein Entleervorgang besteht aus
+ * plattform_aim(), der zurückgegebenen Restzeit warten, plattform_tilt(),
+ * config.empty_ms warten, plattform_park() und config.level_ms warten.
+ * Servo-Pulse und Zeiten kommen aus dem Parameterblock (config.h).
+ *
+ * Vorhersage: Jede Plattform zählt die Farbübergänge aufeinanderfolgender
+ * Objekte (Markov-Kette 1. Ordnung). Im Leerlauf steht der Richtungsservo
+ * auf dem wahrscheinlichsten Nachfolger der zuletzt sortierten Farbe. Ist
+ * die Vorhersage richtig, entfällt die Wartezeit vor dem Kippen.
+ * Wird die leere Plattform per Sensor bestätigt, ist config.empty_ms nur
+ * die Obergrenze.
+ *
+ * @note Dieses Modul benötigt den PCA9685 PWM Treiber.
  */
 
 #ifndef PLATFORM_H_
 #define PLATFORM_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "lcd1602_display/lcd1602_manager.h"
+
 /**
  * @brief Servo Kanal Definitionen
  */
-#define RICHTUNGSSERVO 0 /**< PCA9685 Kanal für Richtungssteuerung */
-#define KIPPSERVO 4      /**< PCA9685 Kanal für Kippbewegung */
+#define RICHTUNGSSERVO_0 0  /**< PCA9685 Kanal für Richtungssteuerung, Lane 0 */
+#define KIPPSERVO_0      4  /**< PCA9685 Kanal für Kippbewegung, Lane 0 */
+#define RICHTUNGSSERVO_1 8  /**< PCA9685 Kanal für Richtungssteuerung, Lane 1 */
+#define KIPPSERVO_1      12 /**< PCA9685 Kanal für Kippbewegung, Lane 1 */
+
+/**
+ * @brief Voreinstellungen der Zeiten des Entleervorgangs, zur Laufzeit gelten
+ *        die Werte aus config.h.
+ */
+#define PLATFORM_AIM_MS   700  /**< Richtungsservo erreicht Position */
+#define PLATFORM_EMPTY_MS 1500 /**< Plattform gekippt, vollständig entleert */
+#define PLATFORM_LEVEL_MS 500  /**< Rückkehr in Standardposition */
+#define PLATFORM_EMPTY_MIN_MS 200 /**< Kippen bis zur ersten Leer-Prüfung */
+
+/** @brief Anzahl der Ausgänge (RED, BLUE, GREEN). */
+#define PLATFORM_BINS 3
+
+/** @brief Voreinstellung des Servo-Pulses des Ausschuss-Ausgangs (COLOR UNKNOWN). */
+#define PLATFORM_REJECT_PULSE SERVO_DEG_PULSE_135
+
+/** @brief Wert von aimed, solange die Richtung unbekannt ist. */
+#define PLATFORM_AIM_NONE 0xFF
+
+/** @brief Zählerstand, ab dem eine Zeile der Übergangszählung halbiert wird. */
+#define PLATFORM_COUNT_MAX 255
+
+/**
+ * @brief Servos und Farbvorhersage einer Kippplatform.
+ */
+typedef struct
+{
+    uint8_t  dir_servo;  /**< PCA9685 Kanal für Richtungssteuerung */
+    uint8_t  tilt_servo; /**< PCA9685 Kanal für Kippbewegung */
+
+    uint8_t  aimed;      /**< Aktuelle Richtung (COLOR) */
+    uint32_t t_aimed;    /**< timer_stamp32() der letzten Richtungsänderung */
+    uint8_t  last;       /**< Zuletzt sortierte Farbe, PLATFORM_BINS = keine */
+    uint8_t  next[PLATFORM_BINS][PLATFORM_BINS]; /**< Übergangszähler [last][next] */
+} platform_t;
+
+/**
+ * @brief Setzt die Vorhersage zurück und fährt in die Schlafposition.
+ *
+ * @param[in,out] plat Plattform.
+ */
+void plattform_init(platform_t *plat);
+
+/**
+ * @brief Setzt die Vorhersage zurück und übernimmt eine gesicherte Position.
+ *
+ * Für den Wiederanlauf nach einem Reset (siehe snapshot.h): Die Servos
+ * haben ihre Stellung behalten, die Plattform wird waagrecht auf
+ * @p aimed gestellt und gilt als ausgerichtet. Mit PLATFORM_AIM_NONE
+ * fährt sie wie bei plattform_level() in die Standardposition, die erste
+ * Ausrichtung wartet dann voll.
+ *
+ * @param[in,out] plat  Plattform.
+ * @param[in]     aimed Gesicherte Richtung (COLOR) oder PLATFORM_AIM_NONE.
+ */
+void plattform_resume(platform_t *plat, uint8_t aimed);
 
 /**
  * @brief Setzt die Plattform in ihre Standardposition.
+ *
+ * @param[in,out] plat Plattform.
  */
-void plattform_default_position(void);
+void plattform_level(platform_t *plat);
 
 /**
  * @brief Setzt die Plattform in ihre Schlafposition.
+ *
+ * @param[in,out] plat Plattform.
  */
-void plattform_sleep_position(void);
+void plattform_sleep_position(platform_t *plat);
 
 /**
- * @brief Führt die Kippbewegung zum Entleeren der Plattform aus.
+ * @brief Richtet die Plattform auf den Ausgang einer Farbe aus.
  *
- * Diese Funktion führt die eigentliche Entleerungssequenz aus:
- *   1. 500ms Verzögerung vor der Bewegung
- *   2. Kippservo auf 45° (Entleerungsposition)
- *   3. 1000ms warten für vollständiges Entleeren
- *   4. Rückkehr zur Standardposition
+ * Voreinstellung: Rot → 50°, Grün → 90°, UNKNOWN → Ausschuss (135°), Blau → 120°.
  *
- * @note Diese Funktion wird normalerweise nicht direkt aufgerufen,
- *       sondern über die farbspezifischen Entleerungsfunktionen.
+ * @param[in,out] plat  Plattform.
+ * @param[in]     color Ziel-Farbe.
+ * @return Restzeit in ms, bis der Richtungsservo die Position erreicht hat
+ *         (0 wenn er bereits lange genug dort steht).
  */
-void plattform_empty(void);
+uint16_t plattform_aim(platform_t *plat, COLOR color);
 
 /**
- * @brief Entleert die Plattform in Richtung Rot.
+ * @brief Nimmt eine sortierte Farbe in die Übergangszählung auf.
+ *
+ * @param[in,out] plat  Plattform.
+ * @param[in]     color Sortierte Farbe.
  */
-void plattform_empty_r(void);
+void plattform_learn(platform_t *plat, COLOR color);
 
 /**
- * @brief Entleert die Plattform in Richtung Grün.
+ * @brief Bringt die Plattform waagrecht und richtet sie auf die vorhergesagte Farbe.
+ *
+ * Ohne Vorhersage bleibt die Richtung unverändert.
+ *
+ * @param[in,out] plat Plattform.
  */
-void plattform_empty_g(void);
+void plattform_park(platform_t *plat);
 
 /**
- * @brief Entleert die Plattform in Richtung Blau.
+ * @brief Kippt die Plattform zum Entleeren (Voreinstellung 40°).
+ *
+ * @param[in] plat Plattform.
  */
-void plattform_empty_b(void);
+void plattform_tilt(const platform_t *plat);
 
 #endif /* PLATFORM_H_ */
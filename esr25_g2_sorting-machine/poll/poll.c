@@ -0,0 +1,71 @@
+/* ========================================================================== */
+/* poll.c                                                                     */
+/* ========================================================================== */
+/**
+ * @file      poll.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der lastabhängigen Erkennungsperiode.
+ */
+
+#include "poll.h"
+#include "timer/timer.h"
+#include <stdint.h>
+
+static uint16_t min_ms = POLL_FAST_MS;
+static uint16_t max_ms = POLL_SLOW_MS;
+static uint16_t period_ms = POLL_SLOW_MS;
+
+/**
+ * @brief Übernimmt eine Periode in den System-Tick.
+ */
+static void apply(uint16_t ms)
+{
+    if (ms < min_ms)
+        ms = min_ms;
+    if (ms > max_ms)
+        ms = max_ms;
+
+    if (ms != period_ms)
+    {
+        period_ms = ms;
+        timer_systick_set_period(ms);
+    }
+}
+
+void poll_set_bounds(uint16_t fast_ms, uint16_t slow_ms)
+{
+    if (slow_ms == 0 || slow_ms > TIMER_SYSTICK_MAX_MS)
+        slow_ms = TIMER_SYSTICK_MAX_MS;
+    if (fast_ms == 0)
+        fast_ms = 1;
+    if (fast_ms > slow_ms)
+        fast_ms = slow_ms;
+
+    min_ms = fast_ms;
+    max_ms = slow_ms;
+    apply(period_ms);
+}
+
+void poll_activity(void)
+{
+    apply(min_ms);
+}
+
+void poll_tick(void)
+{
+    // Mindestens 1 ms, sonst wächst eine sehr kurze Periode nie
+    apply(period_ms + (period_ms >> POLL_GROWTH_SHIFT) + 1);
+}
+
+void poll_reset(void)
+{
+    period_ms = max_ms;
+    timer_systick_set_period(max_ms);
+}
+
+uint16_t poll_period_ms(void)
+{
+    return period_ms;
+}
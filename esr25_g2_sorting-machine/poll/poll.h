@@ -0,0 +1,81 @@
+/* ========================================================================== */
+/* poll.h                                                                     */
+/* ========================================================================== */
+/**
+ * @file      poll.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Lastabhängige Periode der Objekterkennung.
+ *
+ * Im Auto-Modus startet jeder System-Tick eine Objekterkennung auf allen
+ * freien Lanes. Die Tick-Periode passt sich der Aktivität an:
+ *   - Nach jedem sortierten Objekt fällt sie auf die schnelle Periode
+ *   - Mit jedem Tick ohne Objekt wächst sie um 1/2^POLL_GROWTH_SHIFT,
+ *     bis die langsame Periode erreicht ist
+ *
+ * Während einer Serie werden Objekte so nach kurzer Zeit erkannt, im
+ * Leerlauf wacht die CPU nur selten auf. Beide Grenzen sind zur Laufzeit
+ * einstellbar.
+ */
+
+#ifndef POLL_POLL_H_
+#define POLL_POLL_H_
+
+#include <stdint.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Voreingestellte schnelle Periode in ms. */
+#define POLL_FAST_MS       150U
+
+/** @brief Voreingestellte langsame Periode in ms. */
+#define POLL_SLOW_MS       2000U
+
+/** @brief Wachstum je Tick ohne Objekt: Periode += Periode >> POLL_GROWTH_SHIFT. */
+#define POLL_GROWTH_SHIFT  3
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Setzt die Grenzen der Periode.
+ *
+ * Die Werte werden auf 1-TIMER_SYSTICK_MAX_MS begrenzt, @p fast_ms höchstens
+ * @p slow_ms. Die aktuelle Periode wird in die neuen Grenzen geholt.
+ *
+ * @param[in] fast_ms Periode direkt nach einem sortierten Objekt.
+ * @param[in] slow_ms Periode im Leerlauf.
+ */
+void poll_set_bounds(uint16_t fast_ms, uint16_t slow_ms);
+
+/**
+ * @brief Meldet ein sortiertes Objekt und wechselt auf die schnelle Periode.
+ */
+void poll_activity(void);
+
+/**
+ * @brief Verlängert die Periode nach einem Tick.
+ *
+ * Wird bei jedem System-Tick im Auto-Modus aufgerufen.
+ */
+void poll_tick(void);
+
+/**
+ * @brief Setzt die Periode auf die langsame Grenze zurück.
+ *
+ * Wird beim Start des Auto-Modus aufgerufen.
+ */
+void poll_reset(void);
+
+/**
+ * @brief Liefert die aktuelle Periode.
+ *
+ * @return Periode in ms.
+ */
+uint16_t poll_period_ms(void);
+
+#endif /* POLL_POLL_H_ */
@@ -0,0 +1,183 @@
+/* ========================================================================== */
+/* power.c                                                                    */
+/* ========================================================================== */
+/**
+ * @file      power.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der Energiebilanz.
+ */
+
+#include "power.h"
+#include "config/config.h"
+#include "clock/clock.h"
+#include "timer/timer.h"
+#include <msp430.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/** @brief Verweildauer [State][Modus] in Ticks. */
+static uint32_t times[POWER_STATES][POWER_MODES];
+
+/** @brief Ladung je State in µA·Tick. */
+static uint64_t charge[POWER_STATES];
+
+/** @brief Sortierte Objekte seit dem letzten Zurücksetzen. */
+static uint32_t pills = 0;
+
+/** @brief Laufender Abschnitt: Beginn, Modus und State. */
+static uint32_t t_last = 0;
+static uint8_t mode_now = POWER_ACTIVE;
+static uint8_t state_now = 0;
+
+/** @brief MCLK in MHz, aktualisiert bei jedem Taktwechsel. */
+static uint8_t mclk_mhz = 1;
+
+/**
+ * @brief Stromaufnahme in einem Modus nach dem Parameterblock.
+ *
+ * @return Strom in µA, begrenzt auf 16 Bit.
+ */
+static uint16_t current_ua(uint8_t mode)
+{
+    uint32_t ua = config.base_ua;
+
+    if (mode == POWER_ACTIVE)
+        ua += (uint32_t)config.active_ua_mhz * mclk_mhz;
+    else if (mode == POWER_LPM0)
+        ua += config.lpm0_ua;
+    else
+        ua += config.lpm3_ua;
+
+    return (ua > 0xFFFF) ? 0xFFFF : (uint16_t)ua;
+}
+
+/**
+ * @brief Schließt den laufenden Abschnitt ab und beginnt einen neuen.
+ *
+ * Nur mit gesperrten Interrupts aufrufen.
+ *
+ * @param[in] mode Modus des neuen Abschnitts.
+ */
+static void account(uint8_t mode)
+{
+    uint32_t now = timer_stamp32();
+    uint32_t ticks = now - t_last;
+
+    times[state_now][mode_now] += ticks;
+    charge[state_now] += (uint64_t)ticks * current_ua(mode_now);
+
+    t_last = now;
+    mode_now = mode;
+}
+
+/**
+ * @brief Übernimmt die neue MCLK, bisherige Zeit zählt zum alten Takt.
+ */
+static void clock_changed(uint32_t smclk_hz)
+{
+    uint16_t gie = __get_SR_register() & GIE;
+
+    __disable_interrupt();
+    account(mode_now);
+    mclk_mhz = (uint8_t)((smclk_hz + 500000UL) / 1000000UL);
+    __bis_SR_register(gie);
+}
+
+void power_init(void)
+{
+    mclk_mhz = (uint8_t)((clock_mclk_hz() + 500000UL) / 1000000UL);
+    clock_register_listener(clock_changed);
+    power_reset();
+}
+
+void power_sleep(uint8_t mode)
+{
+    uint16_t gie = __get_SR_register() & GIE;
+
+    __disable_interrupt();
+    account(mode);
+
+    if (mode == POWER_LPM0)
+        __bis_SR_register(LPM0_bits | GIE);
+    else
+        __bis_SR_register(LPM3_bits | GIE);
+
+    __disable_interrupt();
+    account(POWER_ACTIVE);
+    __bis_SR_register(gie);
+}
+
+void power_set_state(uint8_t state)
+{
+    uint16_t gie;
+
+    if (state >= POWER_STATES || state == state_now)
+        return;
+
+    gie = __get_SR_register() & GIE;
+    __disable_interrupt();
+    account(mode_now);
+    state_now = state;
+    __bis_SR_register(gie);
+}
+
+void power_pill(void)
+{
+    pills++;
+}
+
+uint32_t power_time(uint8_t state, uint8_t mode)
+{
+    uint16_t gie;
+    uint32_t t;
+
+    if (state >= POWER_STATES || mode >= POWER_MODES)
+        return 0;
+
+    gie = __get_SR_register() & GIE;
+    __disable_interrupt();
+    account(mode_now);
+    t = times[state][mode];
+    __bis_SR_register(gie);
+
+    return t;
+}
+
+uint32_t power_energy_uj(uint8_t state)
+{
+    uint16_t gie = __get_SR_register() & GIE;
+    uint64_t q = 0;
+    uint8_t i;
+
+    __disable_interrupt();
+    account(mode_now);
+    for (i = 0; i < POWER_STATES; i++)
+    {
+        if (state == i || state >= POWER_STATES)
+            q += charge[i];
+    }
+    __bis_SR_register(gie);
+
+    // µA·Tick × mV = nW·Tick, 1 µJ = 1000 nW · 1 s = 1000 · TIMER_STAMP_HZ nW·Tick
+    return (uint32_t)((q * config.supply_mv) / (1000ULL * TIMER_STAMP_HZ));
+}
+
+uint32_t power_pills(void)
+{
+    return pills;
+}
+
+void power_reset(void)
+{
+    uint16_t gie = __get_SR_register() & GIE;
+
+    __disable_interrupt();
+    memset(times, 0, sizeof(times));
+    memset(charge, 0, sizeof(charge));
+    pills = 0;
+    t_last = timer_stamp32();
+    __bis_SR_register(gie);
+}
@@ -0,0 +1,131 @@
+/* ========================================================================== */
+/* power.h                                                                    */
+/* ========================================================================== */
+/**
+ * @file      power.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Verweildauer in den Energiesparmodi und Energie je Objekt.
+ *
+ * Alle Wartestellen (Main Loop, timer_sleep_ms(), I2C) betreten den LPM
+ * über power_sleep(). Bei jedem Wechsel zwischen Aktivbetrieb, LPM0 und
+ * LPM3 wird die Zeit seit dem letzten Wechsel dem bisherigen Modus und dem
+ * aktuellen State (State_t) gutgeschrieben. Gemessen wird mit
+ * timer_stamp32(), auch lange Abschnitte im LPM3 laufen nicht über.
+ *
+ * Aus den Zeiten und der Stromaufnahme je Modus aus dem Parameterblock
+ * (config.h) ergibt sich die Ladung und mit der Versorgungsspannung die
+ * Energie. Der Aktivstrom skaliert mit der MCLK des Taktprofils. Geteilt
+ * durch die sortierten Objekte ergibt sich die Energie je Objekt, mit der
+ * sich Firmwarestände vergleichen lassen.
+ *
+ * Die Zeiten sind Ticks von timer_stamp() (1/TIMER_STAMP_HZ s). Kürzere
+ * Abschnitte (z.B. einzelne I2C-Übertragungen) werden gerundet, der Fehler
+ * mittelt sich über viele Abschnitte heraus. ISRs zählen zum Modus, aus
+ * dem sie die CPU wecken.
+ */
+
+#ifndef POWER_POWER_H_
+#define POWER_POWER_H_
+
+#include <stdint.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief CPU aktiv. */
+#define POWER_ACTIVE  0
+
+/** @brief LPM0, MCLK aus. */
+#define POWER_LPM0    1
+
+/** @brief LPM3, nur ACLK läuft. */
+#define POWER_LPM3    2
+
+/** @brief Anzahl der erfassten Modi. */
+#define POWER_MODES   3
+
+/** @brief Anzahl der erfassten States (State_t). */
+#define POWER_STATES  5
+
+/** @brief Voreinstellung Aktivstrom in µA je MHz MCLK (Datenblatt, FRAM). */
+#define POWER_ACTIVE_UA_MHZ  120U
+
+/** @brief Voreinstellung Strom im LPM0 in µA. */
+#define POWER_LPM0_UA        70U
+
+/** @brief Voreinstellung Strom im LPM3 in µA. */
+#define POWER_LPM3_UA        2U
+
+/** @brief Voreinstellung Grundlast der übrigen Baugruppen in µA. */
+#define POWER_BASE_UA        0U
+
+/** @brief Voreinstellung Versorgungsspannung in mV. */
+#define POWER_SUPPLY_MV      3300U
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Startet die Erfassung im Aktivbetrieb.
+ *
+ * Aufruf nach timer_init() und config_init().
+ */
+void power_init(void);
+
+/**
+ * @brief Betritt einen Energiesparmodus bis zum Wecken durch eine ISR.
+ *
+ * Interrupts sind während des LPM freigegeben, danach ist der Zustand
+ * wie vor dem Aufruf. So kann ein Aufrufer mit gesperrten Interrupts
+ * prüfen und ohne verlorenes Wecksignal schlafen.
+ *
+ * @param[in] mode POWER_LPM0 oder POWER_LPM3.
+ */
+void power_sleep(uint8_t mode);
+
+/**
+ * @brief Meldet den aktuellen State, ab jetzt wird ihm die Zeit zugerechnet.
+ *
+ * @param[in] state State_t.
+ */
+void power_set_state(uint8_t state);
+
+/**
+ * @brief Meldet ein sortiertes Objekt.
+ */
+void power_pill(void);
+
+/**
+ * @brief Liefert die Verweildauer in einem Modus während eines States.
+ *
+ * @param[in] state State_t.
+ * @param[in] mode  POWER_ACTIVE, POWER_LPM0 oder POWER_LPM3.
+ * @return Zeit in Ticks, 0 bei ungültigen Argumenten.
+ */
+uint32_t power_time(uint8_t state, uint8_t mode);
+
+/**
+ * @brief Liefert die geschätzte Energie während eines States.
+ *
+ * @param[in] state State_t, POWER_STATES für die Summe aller States.
+ * @return Energie in µJ.
+ */
+uint32_t power_energy_uj(uint8_t state);
+
+/**
+ * @brief Liefert die Anzahl sortierter Objekte seit dem letzten Zurücksetzen.
+ *
+ * @return Objekte.
+ */
+uint32_t power_pills(void);
+
+/**
+ * @brief Setzt alle Zeiten, Energien und Objekte zurück.
+ */
+void power_reset(void);
+
+#endif /* POWER_POWER_H_ */
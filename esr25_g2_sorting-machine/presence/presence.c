@@ -0,0 +1,44 @@
+/* ========================================================================== */
+/* presence.c                                                                 */
+/* ========================================================================== */
+/**
+ * @file      presence.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der Geräteerkennung.
+ */
+
+#include "presence.h"
+#include "PCA9685/PCA9685.h"
+#include "TCS34725/TCS34725.h"
+#include "lcd1602_display/lcd1602.h"
+
+/** Bitmap der vorhandenen Geräte. */
+static uint8_t present = 0;
+
+uint8_t presence_scan(void)
+{
+    present = 0;
+
+    if (PCA9685_probe())
+        present |= PRESENT_PCA9685;
+    if (lcd1602_probe())
+        present |= PRESENT_LCD;
+    if (TCS_probe(&TCS_sensor0))
+        present |= PRESENT_TCS0;
+    if (TCS_probe(&TCS_sensor1))
+        present |= PRESENT_TCS1;
+
+    return present;
+}
+
+uint8_t presence_get(void)
+{
+    return present;
+}
+
+bool presence_has(uint8_t mask)
+{
+    return (present & mask) == mask;
+}
@@ -0,0 +1,64 @@
+/* ========================================================================== */
+/* presence.h                                                                 */
+/* ========================================================================== */
+/**
+ * @file      presence.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Erkennung der angeschlossenen I²C-Geräte beim Start.
+ *
+ * presence_scan() fragt jedes bekannte Gerät einmal mit I2C_probe() ab
+ * und legt das Ergebnis als Bitmap ab. Die Treiber merken sich fehlende
+ * Geräte selbst und kehren danach ohne Busverkehr zurück; ohne Display
+ * entfallen z.B. die Wartezeiten der Initialisierung und jede Ausgabe.
+ *
+ * Die State Machine entscheidet anhand der Bitmap, ob Sortieren möglich
+ * ist; Lanes ohne Farbsensor bleiben außer Betrieb.
+ */
+
+#ifndef PRESENCE_PRESENCE_H_
+#define PRESENCE_PRESENCE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+#define PRESENT_PCA9685 0x01 /**< Servotreiber an I2C_bus0 */
+#define PRESENT_LCD     0x02 /**< LCD1602 an I2C_bus0 */
+#define PRESENT_TCS0    0x04 /**< Farbsensor der Lane 0 an I2C_bus1 */
+#define PRESENT_TCS1    0x08 /**< Farbsensor der Lane 1 an I2C_bus0 */
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Prüft alle bekannten Geräte.
+ *
+ * Muss nach I2C_init() und vor der Initialisierung der Geräte aufgerufen
+ * werden.
+ *
+ * @return Bitmap der vorhandenen Geräte (PRESENT_*).
+ */
+uint8_t presence_scan(void);
+
+/**
+ * @brief Liefert die Bitmap des letzten presence_scan().
+ *
+ * @return Bitmap der vorhandenen Geräte (PRESENT_*).
+ */
+uint8_t presence_get(void);
+
+/**
+ * @brief Prüft, ob alle Geräte aus @p mask vorhanden sind.
+ *
+ * @param[in] mask PRESENT_* Bits.
+ * @return true wenn jedes Gerät aus @p mask geantwortet hat.
+ */
+bool presence_has(uint8_t mask);
+
+#endif /* PRESENCE_PRESENCE_H_ */
@@ -0,0 +1,163 @@
+/* ========================================================================== */
+/* pt.c                                                                       */
+/* ========================================================================== */
+/**
+ * @file      pt.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung des kooperativen Schedulers.
+ */
+
+#include "pt.h"
+#include "state_machine/state_machine.h"
+#include "timer/timer.h"
+#include <msp430.h>
+#include <stddef.h>
+
+/** Laufende Tasks. */
+static pt_task_t *tasks[PT_MAX_TASKS];
+
+/** Ereignisbits für PT_WAIT_EVENT(). */
+static volatile uint16_t pt_events = 0;
+
+/** Früheste Weckzeit des laufenden pt_run() Durchgangs. */
+static uint16_t next_wake;
+
+/** next_wake ist gültig. */
+static bool have_wake;
+
+/**
+ * @brief Weckzeit erreicht, wird im Interrupt-Kontext aufgerufen.
+ */
+static void pt_alarm(void)
+{
+    EVENT_POST(EVT_TASK);
+}
+
+bool pt_task_start(pt_task_t *task, pt_func_t func, void *ctx)
+{
+    uint8_t i, free = PT_MAX_TASKS;
+
+    for (i = 0; i < PT_MAX_TASKS; i++)
+    {
+        if (tasks[i] == task)
+            break;
+        if (tasks[i] == NULL && free == PT_MAX_TASKS)
+            free = i;
+    }
+
+    if (i == PT_MAX_TASKS)
+    {
+        if (free == PT_MAX_TASKS)
+            return false;
+        tasks[free] = task;
+    }
+
+    PT_INIT(&task->pt);
+    task->func = func;
+    task->ctx = ctx;
+    task->running = true;
+
+    pt_notify();
+    return true;
+}
+
+void pt_task_stop(pt_task_t *task)
+{
+    uint8_t i;
+
+    task->running = false;
+
+    for (i = 0; i < PT_MAX_TASKS; i++)
+    {
+        if (tasks[i] == task)
+            tasks[i] = NULL;
+    }
+}
+
+bool pt_task_running(const pt_task_t *task)
+{
+    return task->running;
+}
+
+void pt_run(void)
+{
+    bool yielded = false;
+    uint8_t i;
+    char state;
+
+    have_wake = false;
+
+    for (i = 0; i < PT_MAX_TASKS; i++)
+    {
+        if (tasks[i] == NULL)
+            continue;
+
+        state = tasks[i]->func(&tasks[i]->pt, tasks[i]->ctx);
+
+        // Ein Task kann während seines Laufs gestoppt worden sein
+        if (tasks[i] == NULL)
+            continue;
+
+        if (state >= PT_EXITED)
+            pt_task_stop(tasks[i]);
+        else if (state == PT_YIELDED)
+            yielded = true;
+    }
+
+    if (yielded)
+        pt_notify();
+
+    if (have_wake)
+        timer_alarm_at(next_wake, pt_alarm);
+    else
+        timer_alarm_stop();
+}
+
+void pt_signal(uint16_t mask)
+{
+    pt_events |= mask;
+    EVENT_POST(EVT_TASK);
+}
+
+void pt_notify(void)
+{
+    EVENT_POST(EVT_TASK);
+}
+
+uint16_t pt_deadline(uint16_t ms)
+{
+    if (ms > PT_WAIT_MS_MAX)
+        ms = PT_WAIT_MS_MAX;
+
+    return timer_stamp() + timer_ms_to_stamp(ms);
+}
+
+bool pt_due(uint16_t stamp)
+{
+    uint16_t now = timer_stamp();
+
+    if ((int16_t)(stamp - now) <= 0)
+        return true;
+
+    if (!have_wake || (int16_t)(stamp - next_wake) < 0)
+    {
+        next_wake = stamp;
+        have_wake = true;
+    }
+    return false;
+}
+
+bool pt_take_event(uint16_t mask)
+{
+    uint16_t gie = __get_SR_register() & GIE;
+    uint16_t set;
+
+    __disable_interrupt();
+    set = pt_events & mask;
+    pt_events &= ~set;
+    __bis_SR_register(gie);
+
+    return set != 0;
+}
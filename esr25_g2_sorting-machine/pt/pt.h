@@ -0,0 +1,238 @@
+/* ========================================================================== */
+/* pt.h                                                                       */
+/* ========================================================================== */
+/**
+ * @file      pt.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Protothreads und kooperativer Scheduler.
+ *
+ * Ein Protothread ist eine Funktion, die an Wartepunkten zur Main Loop
+ * zurückkehrt und beim nächsten Aufruf dort weiterläuft. Der Fortsetzungs-
+ * punkt wird als Zeilennummer in pt_t gespeichert (switch/case), ein
+ * eigener Stack je Task ist nicht nötig. Ein Task belegt nur sein pt_t
+ * und die Daten, die er selbst über Wartepunkte hinweg braucht.
+ *
+ * Regeln für Protothread-Funktionen:
+ *   - Lokale Variablen verlieren an jedem Wartepunkt ihren Wert; Zustand
+ *     gehört in den Kontext des Tasks oder in static Variablen
+ *   - Innerhalb eines Protothreads darf kein eigenes switch einen
+ *     Wartepunkt enthalten
+ *   - Pro Zeile höchstens ein Wartepunkt
+ *
+ * Primitive:
+ *   - PT_WAIT_UNTIL() / PT_WAIT_WHILE() – Bedingung abwarten
+ *   - PT_WAIT_MS()    – Zeit abwarten (Zeitstempel von Timer_B3)
+ *   - PT_WAIT_EVENT() – Ereignisbit abwarten und quittieren
+ *   - PT_SPAWN()      – Kind-Protothread bis zu seinem Ende ausführen
+ *   - PT_YIELD()      – Andere Tasks vorlassen
+ *   - PT_EXIT()       – Task beenden
+ *
+ * Der Scheduler führt alle gestarteten Tasks bei EVT_TASK aus und stellt
+ * anschließend die Weckzeit von Timer_B3 CCR2 auf den frühesten Ablauf
+ * eines PT_WAIT_MS(). pt_signal() und pt_notify() lösen EVT_TASK aus.
+ */
+
+#ifndef PT_PT_H_
+#define PT_PT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Maximale Anzahl gleichzeitig gestarteter Tasks. */
+#define PT_MAX_TASKS 7
+
+/**
+ * @brief Längste Wartezeit für PT_WAIT_MS() in ms.
+ *
+ * Der Abstand zur Weckzeit muss als int16_t positiv bleiben: 8000 ms sind
+ * bereits 32768 Ticks und würden als sofort fällig gelten.
+ */
+#define PT_WAIT_MS_MAX 7999U
+
+#define PT_WAITING 0 /**< Protothread wartet */
+#define PT_YIELDED 1 /**< Protothread hat freiwillig abgegeben */
+#define PT_EXITED  2 /**< Protothread wurde mit PT_EXIT() beendet */
+#define PT_ENDED   3 /**< Protothread hat PT_END() erreicht */
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Zustand eines Protothreads.
+ */
+typedef struct
+{
+    uint16_t lc;   /**< Fortsetzungspunkt (Zeilennummer, 0 = Anfang) */
+    uint16_t wake; /**< Zeitstempel des laufenden PT_WAIT_MS() */
+} pt_t;
+
+/** @brief Signatur eines Tasks. */
+typedef char (*pt_func_t)(pt_t *pt, void *ctx);
+
+/**
+ * @brief Vom Scheduler ausgeführter Task.
+ */
+typedef struct
+{
+    pt_t      pt;      /**< Zustand des Protothreads */
+    pt_func_t func;    /**< Protothread-Funktion */
+    void     *ctx;     /**< Kontext, wird an func übergeben */
+    bool      running; /**< Task ist gestartet und nicht beendet */
+} pt_task_t;
+
+/* ========================================================================== */
+/* Protothread Makros                                                         */
+/* ========================================================================== */
+
+/** @brief Deklariert eine Protothread-Funktion. */
+#define PT_THREAD(decl) char decl
+
+/** @brief Setzt einen Protothread auf den Anfang zurück. */
+#define PT_INIT(pt) ((pt)->lc = 0)
+
+/** @brief Beginn des Protothread-Körpers. */
+#define PT_BEGIN(pt)                                                         \
+    {                                                                        \
+        char pt_yield_flag = 1;                                              \
+        (void)pt_yield_flag;                                                 \
+        switch ((pt)->lc)                                                    \
+        {                                                                    \
+        case 0:
+
+/** @brief Ende des Protothread-Körpers. */
+#define PT_END(pt)                                                           \
+        }                                                                    \
+        PT_INIT(pt);                                                         \
+        return PT_ENDED;                                                     \
+    }
+
+/** @brief Wartet, bis @p cond wahr ist. */
+#define PT_WAIT_UNTIL(pt, cond)                                              \
+    do                                                                       \
+    {                                                                        \
+        (pt)->lc = __LINE__;                                                 \
+    case __LINE__:                                                           \
+        if (!(cond))                                                         \
+            return PT_WAITING;                                               \
+    } while (0)
+
+/** @brief Wartet, solange @p cond wahr ist. */
+#define PT_WAIT_WHILE(pt, cond) PT_WAIT_UNTIL((pt), !(cond))
+
+/** @brief Wartet @p ms Millisekunden (0-PT_WAIT_MS_MAX, größere Werte werden begrenzt). */
+#define PT_WAIT_MS(pt, ms)                                                   \
+    do                                                                       \
+    {                                                                        \
+        (pt)->wake = pt_deadline(ms);                                        \
+        PT_WAIT_UNTIL((pt), pt_due((pt)->wake));                             \
+    } while (0)
+
+/** @brief Wartet auf eines der Ereignisbits @p mask und quittiert es. */
+#define PT_WAIT_EVENT(pt, mask) PT_WAIT_UNTIL((pt), pt_take_event(mask))
+
+/** @brief Führt den Kind-Protothread @p thread mit Zustand @p child bis zum Ende aus. */
+#define PT_SPAWN(pt, child, thread)                                          \
+    do                                                                       \
+    {                                                                        \
+        PT_INIT(child);                                                      \
+        PT_WAIT_WHILE((pt), (thread) < PT_EXITED);                           \
+    } while (0)
+
+/** @brief Gibt einmal an die anderen Tasks ab. */
+#define PT_YIELD(pt)                                                         \
+    do                                                                       \
+    {                                                                        \
+        pt_yield_flag = 0;                                                   \
+        (pt)->lc = __LINE__;                                                 \
+    case __LINE__:                                                           \
+        if (pt_yield_flag == 0)                                              \
+            return PT_YIELDED;                                               \
+    } while (0)
+
+/** @brief Beendet den Protothread. */
+#define PT_EXIT(pt)                                                          \
+    do                                                                       \
+    {                                                                        \
+        PT_INIT(pt);                                                         \
+        return PT_EXITED;                                                    \
+    } while (0)
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Startet einen Task von vorne.
+ *
+ * Ein bereits laufender Task wird neu gestartet.
+ *
+ * @param[in,out] task Task.
+ * @param[in]     func Protothread-Funktion.
+ * @param[in]     ctx  Kontext für @p func.
+ * @return false wenn bereits PT_MAX_TASKS andere Tasks laufen.
+ */
+bool pt_task_start(pt_task_t *task, pt_func_t func, void *ctx);
+
+/**
+ * @brief Beendet einen Task, ohne ihn weiter auszuführen.
+ *
+ * @param[in,out] task Task.
+ */
+void pt_task_stop(pt_task_t *task);
+
+/**
+ * @brief Prüft, ob ein Task läuft.
+ *
+ * @param[in] task Task.
+ * @return true wenn gestartet und nicht beendet.
+ */
+bool pt_task_running(const pt_task_t *task);
+
+/**
+ * @brief Führt alle laufenden Tasks einmal aus und stellt die nächste Weckzeit.
+ *
+ * Wird von der State Machine bei EVT_TASK aufgerufen.
+ */
+void pt_run(void);
+
+/**
+ * @brief Setzt Ereignisbits für PT_WAIT_EVENT() und löst EVT_TASK aus.
+ *
+ * Darf auch aus einer ISR aufgerufen werden.
+ *
+ * @param[in] mask Ereignisbits.
+ */
+void pt_signal(uint16_t mask);
+
+/**
+ * @brief Löst EVT_TASK aus, damit geänderte Wartebedingungen geprüft werden.
+ */
+void pt_notify(void);
+
+/**
+ * @brief Berechnet den Zeitstempel in @p ms Millisekunden (für PT_WAIT_MS).
+ *
+ * @param[in] ms Wartezeit in ms, begrenzt auf PT_WAIT_MS_MAX.
+ */
+uint16_t pt_deadline(uint16_t ms);
+
+/**
+ * @brief Prüft, ob @p stamp erreicht ist, und merkt ihn sonst als Weckzeit vor.
+ */
+bool pt_due(uint16_t stamp);
+
+/**
+ * @brief Quittiert gesetzte Ereignisbits aus @p mask (für PT_WAIT_EVENT).
+ *
+ * @return true wenn mindestens ein Bit gesetzt war.
+ */
+bool pt_take_event(uint16_t mask);
+
+#endif /* PT_PT_H_ */
@@ -0,0 +1,103 @@
+/* ========================================================================== */
+/* ramfunc.c                                                                  */
+/* ========================================================================== */
+/**
+ * @file      ramfunc.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Zyklenmessung der aus dem RAM ausgeführten Funktionen.
+ */
+
+#include "ramfunc.h"
+#include "clock/clock.h"
+#include "timer/timer.h"
+#include "state_machine/state_machine.h"
+#include "TCS34725/TCS34725.h"
+#include "I2C/I2C.h"
+#include <msp430.h>
+#include <stdint.h>
+
+/**
+ * @brief Ruft die zu messende Funktion einmal auf.
+ */
+static void run(uint8_t which, uint8_t i)
+{
+    Event_t bits = EVT_UART | EVT_SYSTEM_TICK;
+    uint8_t r, g, b;
+
+    if (which == RAMFUNC_BENCH_EVENT)
+        getEvent(&bits);
+    else if (which == RAMFUNC_BENCH_STAMP)
+        timer_stamp();
+    else if (which == RAMFUNC_BENCH_CLASSIFY)
+        TCS_scale_rgb(4000, 1500 + i, 1200, 900, &r, &g, &b);
+}
+
+/**
+ * @brief Misst RAMFUNC_BENCH_I2C_RUNS Übertragungen auf dem Bus von TCS_sensor0.
+ *
+ * Läuft mit freigegebenen Interrupts, die ISRs beenden jede Übertragung.
+ *
+ * @return MCLK-Zyklen je Übertragung, 0 bei fehlendem Sensor oder Busfehler.
+ */
+static uint16_t bench_i2c(void)
+{
+    TCS_t *tcs = &TCS_sensor0;
+    uint32_t start, ticks, cycles;
+    char value;
+    uint8_t i;
+
+    if (!TCS_present(tcs))
+        return 0;
+
+    start = timer_stamp32();
+    for (i = 0; i < RAMFUNC_BENCH_I2C_RUNS; i++)
+    {
+        if (I2C_read_reg(tcs->dev.bus, tcs->dev.addr, TCS_CMD(TCS34725_CDATAL), &value) != I2C_OK)
+            return 0;
+    }
+    ticks = timer_stamp32() - start;
+
+    // TIMER_STAMP_HZ = 4 × 1024, so bleibt das Produkt in 32 Bit
+    cycles = (ticks * (clock_mclk_hz() / 1024UL)) / (4UL * RAMFUNC_BENCH_I2C_RUNS);
+    return (cycles > 0xFFFF) ? 0xFFFF : (uint16_t)cycles;
+}
+
+uint16_t ramfunc_bench(uint8_t which)
+{
+    clock_profile_t profile = clock_get_profile();
+    uint16_t gie, empty, cycles;
+    uint8_t i;
+
+    if (which >= RAMFUNC_BENCH_COUNT)
+        return 0;
+
+    clock_set_profile(CLOCK_PROFILE_SORT);
+
+    if (which == RAMFUNC_BENCH_I2C)
+    {
+        cycles = bench_i2c();
+        clock_set_profile(profile);
+        return cycles;
+    }
+
+    gie = __get_SR_register() & GIE;
+    __disable_interrupt();
+
+    // Schleife mit Aufruf, aber ohne zu messende Funktion
+    timer_cycles_start();
+    for (i = 0; i < RAMFUNC_BENCH_RUNS; i++)
+        run(RAMFUNC_BENCH_COUNT, i);
+    empty = timer_cycles_stop();
+
+    timer_cycles_start();
+    for (i = 0; i < RAMFUNC_BENCH_RUNS; i++)
+        run(which, i);
+    cycles = timer_cycles_stop();
+
+    __bis_SR_register(gie);
+    clock_set_profile(profile);
+
+    return (cycles > empty) ? (cycles - empty) / RAMFUNC_BENCH_RUNS : 0;
+}
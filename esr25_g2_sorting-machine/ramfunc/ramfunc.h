@@ -0,0 +1,95 @@
+/* ========================================================================== */
+/* ramfunc.h                                                                  */
+/* ========================================================================== */
+/**
+ * @file      ramfunc.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Ausführung häufig laufender ISRs und Funktionen aus dem RAM.
+ *
+ * Über 8 MHz braucht das FRAM Wartezyklen (clock.h), im Sortierprofil mit
+ * 24 MHz zwei je Zugriff außerhalb des FRAM-Cache. Mit RAMFUNC markierte
+ * Funktionen legt der Compiler in .TI.ramfunc, der Linker
+ * (lnk_msp430fr2355.cmd) lädt sie ins FRAM und der Startup-Code kopiert
+ * sie über die BINIT-Tabelle ins RAM. Markiert sind:
+ *   - EUSCI_B0/B1_I2C_ISR und bus_isr() – je Byte einer I2C-Übertragung
+ *   - TIMER0_B1_ISR, TIMER3_B1_ISR – System-Tick, Timeout, Weckzeit
+ *   - getEvent(), timer_stamp(), latency_post() – je Event
+ *   - TCS_scale_rgb() und die Farbentscheidung in lane.c
+ *
+ * Hilfsroutinen der Laufzeitbibliothek (z.B. Division) bleiben im FRAM.
+ *
+ * Schalter RAMFUNC_ENABLE (Voreinstellung 1): mit -DRAMFUNC_ENABLE=0 in
+ * den Compiler-Optionen bleibt alles im FRAM. Für den Vergleich beider
+ * Builds misst ramfunc_bench() die Zyklen je Aufruf im Sortierprofil.
+ */
+
+#ifndef RAMFUNC_RAMFUNC_H_
+#define RAMFUNC_RAMFUNC_H_
+
+#include <stdint.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+#ifndef RAMFUNC_ENABLE
+/** @brief 1 = markierte Funktionen laufen aus dem RAM. */
+#define RAMFUNC_ENABLE 1
+#endif
+
+#if RAMFUNC_ENABLE
+/** @brief Legt eine Funktion in .TI.ramfunc. */
+#define RAMFUNC __attribute__((ramfunc))
+#else
+#define RAMFUNC
+#endif
+
+/** @brief Messung von getEvent(). */
+#define RAMFUNC_BENCH_EVENT    0
+
+/** @brief Messung von timer_stamp(). */
+#define RAMFUNC_BENCH_STAMP    1
+
+/** @brief Messung von TCS_scale_rgb(). */
+#define RAMFUNC_BENCH_CLASSIFY 2
+
+/** @brief Messung einer I2C-Übertragung von START bis STOP (ISRs, Wecken). */
+#define RAMFUNC_BENCH_I2C      3
+
+/** @brief Anzahl der Messungen. */
+#define RAMFUNC_BENCH_COUNT    4
+
+/** @brief Aufrufe je Messung, gemittelt. */
+#define RAMFUNC_BENCH_RUNS     16
+
+/** @brief I2C-Übertragungen je Messung, gemittelt (Auflösung 1/4096 s). */
+#define RAMFUNC_BENCH_I2C_RUNS 64
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Misst die Laufzeit einer markierten Funktion im Sortierprofil.
+ *
+ * Wechselt kurz in CLOCK_PROFILE_SORT und misst mit gesperrten Interrupts
+ * RAMFUNC_BENCH_RUNS Aufrufe inklusive Schleife. Da die Aufrufe direkt
+ * aufeinander folgen, trifft die FRAM-Version meist den Cache; der
+ * Unterschied ist daher eine untere Grenze für ISRs, die selten laufen.
+ * Nicht während einer I2C-Übertragung aufrufen (clock_set_profile()).
+ *
+ * RAMFUNC_BENCH_I2C misst dagegen die ISRs im Betrieb: RAMFUNC_BENCH_I2C_RUNS
+ * Lesezugriffe auf das Clear-Register von TCS_sensor0, jeweils von START bis
+ * STOP inklusive Byte-ISRs und Wecken aus LPM3. Gemessen wird mit
+ * timer_stamp32(), da SMCLK im LPM3 steht. Den größten Teil bestimmt der
+ * Bustakt, der Unterschied beider Builds ist der Anteil von ISR und Wecken.
+ *
+ * @param[in] which RAMFUNC_BENCH_EVENT, _STAMP, _CLASSIFY oder _I2C.
+ * @return MCLK-Zyklen je Aufruf bzw. Übertragung, 0 bei ungültigem @p which,
+ *         fehlendem Sensor oder Busfehler.
+ */
+uint16_t ramfunc_bench(uint8_t which);
+
+#endif /* RAMFUNC_RAMFUNC_H_ */
@@ -0,0 +1,79 @@
+/* ========================================================================== */
+/* snapshot.c                                                                 */
+/* ========================================================================== */
+/**
+ * @file      snapshot.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung des Snapshots im FRAM.
+ */
+
+#include "snapshot.h"
+#include "fram/fram.h"
+#include <msp430.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Speicherlayout des Snapshots im FRAM.
+ */
+typedef struct
+{
+    uint16_t   magic; /**< SNAPSHOT_MAGIC bei gültigem Inhalt */
+    uint16_t   crc;   /**< CRC-16-CCITT über data */
+    snapshot_t data;  /**< Gesicherter Zustand */
+} snapshot_store_t;
+
+/**
+ * volatile, damit der Compiler die Schreibzugriffe in snapshot_save()
+ * weder umordnet noch das Löschen der Kennung als überflüssig entfernt.
+ */
+#pragma PERSISTENT(snapshot_store)
+volatile snapshot_store_t snapshot_store = { 0 };
+
+/**
+ * @brief Berechnet die CRC des Snapshots im FRAM.
+ *
+ * Gerechnet wird über das Speicherabbild im FRAM, damit Füllbytes beim
+ * Schreiben und Lesen gleich eingehen.
+ *
+ * @return CRC-16-CCITT, Startwert 0xFFFF.
+ */
+static uint16_t snapshot_crc(void)
+{
+    const volatile uint8_t *byte = (const volatile uint8_t *)&snapshot_store.data;
+    uint16_t i;
+
+    CRCINIRES = 0xFFFF;
+
+    for (i = 0; i < sizeof(snapshot_t); i++)
+        CRCDIRB_L = byte[i];
+
+    return CRCINIRES;
+}
+
+void snapshot_save(const snapshot_t *snap)
+{
+    uint16_t wp = fram_unlock();
+
+    snapshot_store.magic = 0;
+    snapshot_store.data = *snap;
+    snapshot_store.crc = snapshot_crc();
+
+    // Kennung zuletzt, erst damit wird der Inhalt gültig
+    snapshot_store.magic = SNAPSHOT_MAGIC;
+
+    fram_lock(wp);
+}
+
+bool snapshot_load(snapshot_t *snap)
+{
+    if (snapshot_store.magic != SNAPSHOT_MAGIC || snapshot_store.crc != snapshot_crc())
+    {
+        return false;
+    }
+
+    *snap = snapshot_store.data;
+    return true;
+}
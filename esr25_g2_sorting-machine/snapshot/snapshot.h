@@ -0,0 +1,86 @@
+/* ========================================================================== */
+/* snapshot.h                                                                 */
+/* ========================================================================== */
+/**
+ * @file      snapshot.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Betriebszustand im FRAM für den Wiederanlauf nach einem Reset.
+ *
+ * Die State Machine legt an festen Punkten einen Snapshot ab:
+ *   - State (damit auch der Sortiermodus)
+ *   - Sortier-Statistik
+ *   - Kalibrierung jeder Lane
+ *   - Richtung jeder Plattform, sofern sie gerade stillsteht
+ *
+ * Beim Schreiben wird zuerst die Kennung gelöscht, dann der Inhalt
+ * geschrieben und zuletzt die Kennung gesetzt. Ein Reset während des
+ * Schreibens hinterlässt daher keinen gültigen, aber halb geschriebenen
+ * Snapshot, sondern gar keinen. Zusätzlich sichert eine CRC-16-CCITT den
+ * Inhalt, ein beschädigter Snapshot wird beim Laden verworfen.
+ */
+
+#ifndef SNAPSHOT_SNAPSHOT_H_
+#define SNAPSHOT_SNAPSHOT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lane/lane.h"
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Kennung eines gültigen Snapshots, wird bei Layoutänderung erhöht. */
+#define SNAPSHOT_MAGIC 0x534FU
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Gesicherter Zustand einer Lane.
+ */
+typedef struct
+{
+    uint16_t clear_ref;   /**< siehe lane_t */
+    uint16_t min_delta;   /**< siehe lane_t */
+    uint16_t empty_ref;   /**< siehe lane_t */
+    uint16_t empty_delta; /**< siehe lane_t */
+    uint8_t  aimed;       /**< Richtung der Plattform, PLATFORM_AIM_NONE = in Bewegung */
+} snapshot_lane_t;
+
+/**
+ * @brief Gesicherter Zustand der Maschine.
+ */
+typedef struct
+{
+    uint8_t         state;        /**< State_t */
+    uint8_t         total_sorted; /**< Sortier-Statistik */
+    uint8_t         red_sorted;
+    uint8_t         green_sorted;
+    uint8_t         blue_sorted;
+    snapshot_lane_t lanes[LANE_COUNT];
+} snapshot_t;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Schreibt einen Snapshot ins FRAM.
+ *
+ * @param[in] snap Zu sichernder Zustand.
+ */
+void snapshot_save(const snapshot_t *snap);
+
+/**
+ * @brief Liest den Snapshot aus dem FRAM.
+ *
+ * @param[out] snap Gesicherter Zustand.
+ * @return true wenn ein gültiger Snapshot mit passender CRC vorliegt.
+ */
+bool snapshot_load(snapshot_t *snap);
+
+#endif /* SNAPSHOT_SNAPSHOT_H_ */
@@ -0,0 +1,118 @@
+/* ========================================================================== */
+/* standby.c                                                                  */
+/* ========================================================================== */
+/**
+ * @file      standby.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung des Standby in LPM4.5/LPM3.5.
+ */
+
+#include "standby.h"
+#include "PCA9685/PCA9685.h"
+#include "TCS34725/TCS34725.h"
+#include "led/led.h"
+#include <msp430.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Gibt die Taster als Weckquelle frei und schaltet ab.
+ *
+ * Die Taster werden wie in button_init() konfiguriert, falls gerade das
+ * Entprellen ihre Interrupts gesperrt hat oder die Ports nach einem
+ * Lebenszeichen noch im Resetzustand sind.
+ */
+static void power_down(void)
+{
+    __disable_interrupt();
+
+    // Taster S1 (P4.1) und S2 (P2.3): Eingang mit Pull-up, fallende Flanke
+    P4DIR &= ~BIT1;
+    P4OUT |= BIT1;
+    P4REN |= BIT1;
+    P4IES |= BIT1;
+    P2DIR &= ~BIT3;
+    P2OUT |= BIT3;
+    P2REN |= BIT3;
+    P2IES |= BIT3;
+    P4IFG &= ~BIT1;
+    P2IFG &= ~BIT3;
+    P4IE |= BIT1;
+    P2IE |= BIT3;
+
+#if STANDBY_RTC_WAKE_S > 0
+    // VLO ≈ 10 kHz / 1000 = 10 Hz, Überlauf nach STANDBY_RTC_WAKE_S
+    RTCMOD = STANDBY_RTC_WAKE_S * 10U - 1U;
+    RTCCTL = RTCSS__VLOCLK | RTCSR | RTCPS__1000 | RTCIE;
+#endif
+
+    // Core-Regler beim Eintritt in den LPM abschalten → LPMx.5
+    PMMCTL0_H = PMMPW_H;
+    PMMCTL0_L &= ~SVSHE;
+    PMMCTL0_L |= PMMREGOFF;
+    PMMCTL0_H = 0;
+
+#if STANDBY_RTC_WAKE_S > 0
+    __bis_SR_register(LPM3_bits | GIE); // LPM3.5
+#else
+    __bis_SR_register(LPM4_bits | GIE); // LPM4.5
+#endif
+
+    // Nur erreichbar, wenn das Weckflag schon vor dem Eintritt gesetzt war
+    PMMCTL0_H = PMMPW_H;
+    PMMCTL0_L |= PMMSWBOR;
+    while (true)
+        ;
+}
+
+standby_wake_t standby_wake_source(void)
+{
+    uint16_t reason;
+    bool lpm5 = false;
+
+    // Alle anstehenden Resetursachen lesen und quittieren
+    while ((reason = SYSRSTIV) != SYSRSTIV_NONE)
+    {
+        if (reason == SYSRSTIV_LPM5WU)
+            lpm5 = true;
+    }
+
+    if (!lpm5)
+        return STANDBY_WAKE_NONE;
+
+    // RTC anhalten, läuft sie nach einem Wecken per Taster weiter, fehlt ihr die ISR
+    reason = RTCIV;
+    RTCCTL = 0;
+
+    if (reason == RTCIV__RTCIFG)
+        return STANDBY_WAKE_RTC;
+    if (P4IFG & BIT1)
+        return STANDBY_WAKE_S1;
+    if (P2IFG & BIT3)
+        return STANDBY_WAKE_S2;
+
+    return STANDBY_WAKE_NONE;
+}
+
+void standby_enter(void)
+{
+    TCS_power_off(&TCS_sensor0);
+    TCS_power_off(&TCS_sensor1);
+    PCA9685_sleep();
+
+    led_sorting_off();
+    led_ready_off();
+
+    power_down();
+}
+
+void standby_heartbeat(void)
+{
+    led_ready_on();
+    __delay_cycles(STANDBY_BLINK_CYCLES);
+    led_ready_off();
+
+    power_down();
+}
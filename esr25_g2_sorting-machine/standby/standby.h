@@ -0,0 +1,93 @@
+/* ========================================================================== */
+/* standby.h                                                                  */
+/* ========================================================================== */
+/**
+ * @file      standby.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Abschalten in LPM4.5 bzw. LPM3.5 und Aufwachen per Taster oder RTC.
+ *
+ * Bleibt die Maschine config.standby_s lang in OFF_STATE und kommt in
+ * dieser Zeit keine Befehlszeile über die UART, schaltet die State Machine
+ * über standby_enter() ab. Im Standby ist die UART nicht erreichbar, ein
+ * Host, der regelmäßig abfragt, hält die Maschine daher wach:
+ *   - Farbsensoren aus (PON = 0) und ihre LEDs aus
+ *   - PCA9685 im SLEEP, die Servos werden nicht mehr angesteuert
+ *   - Status LEDs aus, Display und Hintergrundbeleuchtung sind bereits aus
+ *   - Core-Regler aus, RAM und alle Module außer RTC und I/O ohne Spannung
+ *
+ * Ohne RTC (STANDBY_RTC_WAKE_S = 0) geht es in LPM4.5, sonst in LPM3.5 mit
+ * der RTC aus dem VLO. Die I/Os halten ihren Pegel, beide Taster bleiben
+ * als Weckquelle aktiv.
+ *
+ * Aufwachen ist ein Reset. Der Betriebszustand liegt bereits im Snapshot
+ * (snapshot.h), der Wiederanlauf läuft über die normale Initialisierung.
+ * standby_wake_source() liefert danach den Taster, der geweckt hat, damit
+ * der Druck nicht verloren geht. Ein Wecken durch die RTC ist nur ein
+ * Lebenszeichen: standby_heartbeat() lässt die Bereitschafts-LED kurz
+ * aufblinken und schaltet ohne I2C-Verkehr sofort wieder ab.
+ */
+
+#ifndef STANDBY_STANDBY_H_
+#define STANDBY_STANDBY_H_
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Voreinstellung Ruhezeit in OFF_STATE bis zum Abschalten in s (config.h). */
+#define STANDBY_IDLE_S      600U
+
+/** @brief Periode des Lebenszeichens in s (max. 6553), 0 = ohne RTC in LPM4.5. */
+#define STANDBY_RTC_WAKE_S  0U
+
+/** @brief Dauer des Lebenszeichens in CPU-Zyklen (≈ 20 ms beim Starttakt). */
+#define STANDBY_BLINK_CYCLES 20000UL
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Ursache des letzten Starts.
+ */
+typedef enum
+{
+    STANDBY_WAKE_NONE,    /**< Kein Aufwachen aus dem Standby (Einschalten, Reset) */
+    STANDBY_WAKE_S1,      /**< Taster S1 */
+    STANDBY_WAKE_S2,      /**< Taster S2 */
+    STANDBY_WAKE_RTC      /**< Lebenszeichen der RTC */
+} standby_wake_t;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Ermittelt, wodurch die MCU gestartet wurde.
+ *
+ * Einmal direkt nach dem Löschen von LOCKLPM5 und vor der Konfiguration
+ * der Ports aufrufen, danach sind die Weckflags gelöscht.
+ *
+ * @return Weckquelle.
+ */
+standby_wake_t standby_wake_source(void);
+
+/**
+ * @brief Schaltet die Peripherie ab und betritt LPM4.5 bzw. LPM3.5.
+ *
+ * Aufruf nur mit ausgeschaltetem Display und gesichertem Snapshot.
+ * Kehrt nicht zurück.
+ */
+void standby_enter(void);
+
+/**
+ * @brief Lebenszeichen nach dem Wecken durch die RTC, schaltet danach wieder ab.
+ *
+ * Die Peripherie ist noch vom letzten standby_enter() abgeschaltet, es
+ * werden nur Ports und LEDs benötigt. Kehrt nicht zurück.
+ */
+void standby_heartbeat(void);
+
+#endif /* STANDBY_STANDBY_H_ */
@@ -16,20 +16,25 @@
 #include "state_machine.h"
 #include "TCS34725/TCS34725.h"
 #include "lcd1602_display/lcd1602.h"
-#include "platform/platform.h"
+#include "lane/lane.h"
 #include "lcd1602_display/lcd1602_manager.h"
 #include "timer/timer.h"
 #include "led/led.h"
+#include "clock/clock.h"
+#include "poll/poll.h"
+#include "pt/pt.h"
+#include "presence/presence.h"
+#include "snapshot/snapshot.h"
+#include "command/command.h"
+#include "power/power.h"
+#include "standby/standby.h"
+#include "ramfunc/ramfunc.h"
+#include "uart/uart.h"
+#include "config/config.h"
 #include <msp430.h>
 #include <stdbool.h>
 #include <stdint.h>
 
-/** @brief Referenz Wert für Clear Reading während der Kalibrierung */
-volatile uint16_t clear_ref = 0;
-
-/** @brief Minimum Delta für Clear Wert zur Objekt Erkennung */
-volatile uint16_t MIN_DELTA_CLR = 0;
-
 /** @brief Anzahl aller sortierten Objekte */
 uint8_t total_sorted = 0;
 
@@ -43,74 +48,355 @@ uint8_t green_sorted = 0;
 uint8_t blue_sorted = 0;
 
 /**
- * @brief Kalibriert den Referenz Wert für das Clear Reading.
+ * @brief Sichert State, Statistik, Kalibrierung und Plattformpositionen.
+ *
+ * Die Richtung einer Plattform wird nur übernommen, solange sie stillsteht.
+ *
+ * @param[in] state Zu sichernder State.
+ */
+static void checkpoint(State_t state)
+{
+    snapshot_t snap;
+    uint8_t i;
+
+    snap.state = (uint8_t)state;
+    snap.total_sorted = total_sorted;
+    snap.red_sorted = red_sorted;
+    snap.green_sorted = green_sorted;
+    snap.blue_sorted = blue_sorted;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        snap.lanes[i].clear_ref = lanes[i].clear_ref;
+        snap.lanes[i].min_delta = lanes[i].min_delta;
+        snap.lanes[i].empty_ref = lanes[i].empty_ref;
+        snap.lanes[i].empty_delta = lanes[i].empty_delta;
+        snap.lanes[i].aimed = lane_sorting(&lanes[i]) ? PLATFORM_AIM_NONE
+                                                       : lanes[i].platform.aimed;
+    }
+
+    snapshot_save(&snap);
+}
+
+/** @brief Task, der nach config.standby_s Ruhe in OFF_STATE abschaltet. */
+static pt_task_t standby_task;
+
+/** @brief Beginn der Ruhezeit (timer_stamp32()). */
+static uint32_t standby_from;
+
+/**
+ * @brief Liefert den nächsten Warteschritt bis zum Abschalten.
  *
- * Liest den derzeitigen Clear Wert und setzt ihn als Referenz.
- * Berechnet auch den Minimum Delta Schwellwert als 40% des Referenz Wertes.
+ * Die Ruhezeit zählt ab dem Start des Tasks bzw. ab der letzten
+ * Befehlszeile der UART, je nachdem was später war. Mit config.standby_s = 0
+ * wird in Schritten von PT_WAIT_MS_MAX weiter geprüft.
+ *
+ * @return Restzeit in ms, aufgerundet und begrenzt auf PT_WAIT_MS_MAX,
+ *         0 wenn abgeschaltet werden soll.
  */
-void calibrate_clear(void)
+static uint16_t standby_step_ms(void)
 {
-    uint16_t c;
-    TCS_read_clear(&c);
-    clear_ref = c;
-    MIN_DELTA_CLR = (c * 4) / 10;
+    uint32_t limit = (uint32_t)config.standby_s * TIMER_STAMP_HZ;
+    uint32_t idle = timer_stamp32() - standby_from;
+    uint32_t rx = uart_idle_ticks();
+    uint32_t ms;
+
+    if (config.standby_s == 0)
+        return PT_WAIT_MS_MAX;
+
+    if (rx < idle)
+        idle = rx;
+    if (idle >= limit)
+        return 0;
+
+    ms = timer_stamp32_to_ms(limit - idle) + 1;
+    return (ms > PT_WAIT_MS_MAX) ? PT_WAIT_MS_MAX : (uint16_t)ms;
 }
 
 /**
- * @brief Prüft auf Objekte mittels dem Farbsensor.
+ * @brief Schaltet ab, wenn der State config.standby_s lang OFF_STATE bleibt.
  *
- * Vergleicht den aktuellen Clear Wert mit dem Referenz Wert.
- * Setzt EVT_OBJECT_DETECTED wenn ein Objekt erkannt wurde.
+ * Jede Befehlszeile der UART und jeder neue Eintritt in OFF_STATE startet
+ * die Ruhezeit neu. Die Wartezeit läuft über timer_stamp32() in Schritten
+ * von höchstens PT_WAIT_MS_MAX. Vor dem Abschalten wird gewartet, bis das
+ * Display aus ist, und der Snapshot gesichert.
+ *
+ * @param[in] ctx Pointer auf den aktuellen State.
  */
-void check_for_objects()
+static PT_THREAD(standby_thread(pt_t *pt, void *ctx))
 {
-    uint16_t clear;
-    TCS_read_clear(&clear);
+    const State_t *state = (const State_t *)ctx;
+
+    PT_BEGIN(pt);
+
+    standby_from = timer_stamp32();
+    while (standby_step_ms() != 0)
+        PT_WAIT_MS(pt, standby_step_ms());
+
+    PT_WAIT_WHILE(pt, lcd1602_busy());
 
-    if (clear + MIN_DELTA_CLR < clear_ref)
+    if (*state == OFF_STATE)
     {
-        eventBits |= EVT_OBJECT_DETECTED;
+        checkpoint(OFF_STATE);
+        standby_enter();
     }
+
+    PT_END(pt);
+}
+
+void arm_standby_FSM(State_t *currentState)
+{
+    if (*currentState == OFF_STATE)
+        pt_task_start(&standby_task, standby_thread, currentState);
 }
 
 /**
- * @brief Führt den Sortier Prozess basierend auf der erkannten Farbe durch.
+ * @brief Schaltet das Display aus und wechselt in OFF_STATE.
+ */
+static void enter_off(State_t *currentState)
+{
+    turnDisplayOff();
+    *currentState = OFF_STATE;
+    arm_standby_FSM(currentState);
+}
+
+/**
+ * @brief Führt die fälligen Tasks aus und wertet die Ergebnisse der Lanes aus.
+ *
+ * Zeigt erkannte Farben an, aktualisiert die Sortier Statistiken nach dem
+ * Entleeren und beschleunigt die Objekterkennung. Solange eine Lane misst oder
+ * entleert, läuft das schnelle Taktprofil und die Sortier-LED leuchtet.
+ * Nach jedem entleerten Objekt wird ein Snapshot abgelegt.
  *
- * Liest RGB Werte, bestimmt die dominante Farbe und aktiviert den
- * entsprechenden Sortier Mechanismus. Aktualisiert die Sortier Statistiken
- * und die Anzeige.
+ * @param[in] state Aktueller State (für den Snapshot).
  */
-void do_sort(void)
+static void service_lanes(State_t state)
 {
-    uint8_t r, g, b;
-    led_ready_off();
-    led_sorting_on();
-    TCS_get_rgb(&r, &g, &b);
+    bool sorting = false;
+    bool done = false;
+    uint8_t results;
+    uint8_t i;
+
+    pt_run();
 
-    if (r > g && r > b)
+    for (i = 0; i < LANE_COUNT; i++)
     {
-        plattform_empty_r();
-        writeDetectedColor(RED);
-        red_sorted++;
+        results = lane_take_results(&lanes[i]);
+
+        if (results & LANE_RESULT_SORTING)
+            writeDetectedColor((COLOR)lanes[i].entry.color);
+
+        if (results & LANE_RESULT_DONE)
+        {
+            // Objekte im Ausschuss (UNKNOWN) zählen nicht als sortiert
+            if (lanes[i].entry.color != UNKNOWN)
+            {
+                if (lanes[i].entry.color == RED)
+                    red_sorted++;
+                else if (lanes[i].entry.color == GREEN)
+                    green_sorted++;
+                else
+                    blue_sorted++;
+                total_sorted++;
+                power_pill();
+                writeCurrentCount(total_sorted, blue_sorted, green_sorted, red_sorted);
+            }
+            poll_activity();
+            done = true;
+        }
+
+        if (lane_sorting(&lanes[i]))
+            sorting = true;
     }
-    else if (g > b)
+
+    if (done)
+        checkpoint(state);
+
+    if (sorting)
     {
-        plattform_empty_g();
-        writeDetectedColor(GREEN);
-        green_sorted++;
+        clock_set_profile(CLOCK_PROFILE_SORT);
+        led_ready_off();
+        led_sorting_on();
     }
     else
     {
-        plattform_empty_b();
-        writeDetectedColor(BLUE);
-        blue_sorted++;
+        clock_set_profile(CLOCK_PROFILE_IDLE);
+        led_sorting_off();
+        led_ready_on();
     }
-    total_sorted++;
-    led_sorting_off();
+}
+
+/**
+ * @brief Prüft, ob Servotreiber und mindestens ein Farbsensor vorhanden sind.
+ */
+static bool can_sort(void)
+{
+    return presence_has(PRESENT_PCA9685) &&
+           (presence_get() & (PRESENT_TCS0 | PRESENT_TCS1)) != 0;
+}
+
+/**
+ * @brief Wechselt in einen Sortiermodus.
+ *
+ * Plattformen in Standardposition, Kalibrierung, Zuführungen öffnen; im
+ * Auto-Modus startet zusätzlich der System-Tick der Objekterkennung. Fehlt
+ * die Hardware zum Sortieren, geht es stattdessen in DISPLAY_STATE.
+ *
+ * @param[in,out] currentState Aktueller State.
+ * @param[in]     mode         AUTO_SORT_STATE oder MANUAL_SORT_STATE.
+ * @return true wenn der Sortiermodus aktiv ist.
+ */
+static bool enter_sort(State_t *currentState, State_t mode)
+{
+    if (!can_sort())
+    {
+        lcd1602_show("Hardware fehlt", "S1: aus");
+        *currentState = DISPLAY_STATE;
+        return false;
+    }
+
+    if (mode == AUTO_SORT_STATE)
+    {
+        lcd1602_show("Auto-Sort aktiv", "");
+        lane_level_all();
+        poll_reset();
+        timer_systick_start();
+    }
+    else
+    {
+        lcd1602_show("Manueller Modus", "");
+        lane_level_all();
+    }
+
+    if (!lane_calibrate_all())
+        lcd1602_show((mode == AUTO_SORT_STATE) ? "Auto-Sort aktiv" : "Manueller Modus",
+                     "Kalibr. Fehler");
+
+    lane_feed_all();
     led_ready_on();
+    *currentState = mode;
+    checkpoint(*currentState);
+    return true;
+}
+
+/**
+ * @brief Beendet einen Sortiermodus und schaltet die Maschine aus.
+ *
+ * @param[in,out] currentState Aktueller State.
+ */
+static void stop_sort(State_t *currentState)
+{
+    lane_abort_all();
+    clock_set_profile(CLOCK_PROFILE_IDLE);
+    led_sorting_off();
+    led_ready_off();
+    timer_systick_stop();
+    lane_sleep_all();
+    enter_off(currentState);
+    checkpoint(*currentState);
+}
+
+bool switch_mode_FSM(State_t *currentState, State_t target)
+{
+    bool sorting = (*currentState == AUTO_SORT_STATE || *currentState == MANUAL_SORT_STATE);
+
+    if (target == *currentState)
+        return true;
+
+    if (target != OFF_STATE && target != AUTO_SORT_STATE && target != MANUAL_SORT_STATE)
+        return false;
+
+    if (sorting)
+    {
+        stop_sort(currentState);
+    }
+    else if (target == OFF_STATE)
+    {
+        enter_off(currentState);
+    }
+
+    if (target == OFF_STATE)
+        return true;
+
+    turnDisplayOn();
+    return enter_sort(currentState, target);
+}
+
+bool calibrate_FSM(State_t currentState)
+{
+    bool ok;
+    uint8_t i;
+
+    if (currentState != AUTO_SORT_STATE && currentState != MANUAL_SORT_STATE)
+        return false;
+
+    // Kalibrierung misst blockierend, daher nur zwischen zwei Objekten
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        if (lane_busy(&lanes[i]))
+            return false;
+    }
 
-    timer_sleep_ms(500);
-    writeCurrentCount(total_sorted, blue_sorted, green_sorted, red_sorted);
+    ok = lane_calibrate_all();
+    checkpoint(currentState);
+    return ok;
+}
+
+/**
+ * @brief Setzt die Maschine nach einem Reset aus dem Snapshot fort.
+ *
+ * Statistik und Kalibrierung werden aus jedem gültigen Snapshot übernommen.
+ * War ein Sortiermodus aktiv, geht es ohne Moduswahl und ohne neue
+ * Kalibrierung direkt darin weiter: Plattformen bleiben auf ihrer
+ * gesicherten Position, Zuführungen öffnen sofort.
+ *
+ * @param[out] currentState Fortgesetzter State.
+ * @return true wenn ein Sortiermodus fortgesetzt wurde.
+ */
+bool resume_FSM(State_t *currentState)
+{
+    snapshot_t snap;
+    uint8_t aimed[LANE_COUNT];
+    uint8_t i;
+
+    if (!snapshot_load(&snap))
+        return false;
+
+    total_sorted = snap.total_sorted;
+    red_sorted = snap.red_sorted;
+    green_sorted = snap.green_sorted;
+    blue_sorted = snap.blue_sorted;
+
+    for (i = 0; i < LANE_COUNT; i++)
+    {
+        lanes[i].clear_ref = snap.lanes[i].clear_ref;
+        lanes[i].min_delta = snap.lanes[i].min_delta;
+        lanes[i].empty_ref = snap.lanes[i].empty_ref;
+        lanes[i].empty_delta = snap.lanes[i].empty_delta;
+        aimed[i] = snap.lanes[i].aimed;
+    }
+
+    if ((snap.state != AUTO_SORT_STATE && snap.state != MANUAL_SORT_STATE) || !can_sort())
+        return false;
+
+    lane_resume_all(aimed);
+    turnDisplayOn();
+
+    if (snap.state == AUTO_SORT_STATE)
+    {
+        lcd1602_show("Auto-Sort aktiv", "");
+        poll_reset();
+        timer_systick_start();
+    }
+    else
+    {
+        lcd1602_show("Manueller Modus", "");
+    }
+
+    lane_feed_all();
+    led_ready_on();
+    *currentState = (State_t)snap.state;
+    return true;
 }
 
 /**
@@ -122,7 +408,7 @@ void do_sort(void)
  * @param[in,out] event Pointer zu den Event Bits
  * @return Das Event mit der höchsten Priorität oder EVT_NO_EVENT wenn keine Events vorhanden sind
  */
-Event_t getEvent(Event_t *event)
+RAMFUNC Event_t getEvent(Event_t *event)
 {
     uint16_t ii = 8;
     Event_t bitMask = 0x0080;
@@ -155,8 +441,14 @@ Event_t getEvent(Event_t *event)
  *   - DISPLAY_STATE: Zeigt Sortier Statistiken, kann Zähler zurücksetzen oder zu OFF_STATE wechseln
  *   - MODE_SELECTION_STATE: Auswahl zwischen AUTO_SORT_STATE und MANUAL_SORT_STATE
  *   - AUTO_SORT_STATE: Automatisches Sortieren mit periodischer Objekt Erkennung
+ *     auf allen Lanes
  *   - MANUAL_SORT_STATE: Manuelles Sortieren durch Knopfdruck ausgelöst
  *
+ * Lanes und Display laufen als Tasks des Schedulers (siehe pt.h), die
+ * in jedem State über EVT_TASK ausgeführt werden.
+ * Befehlszeilen der UART (EVT_UART) führt command_process() ebenfalls in
+ * jedem State aus.
+ *
  * @param[in,out] currentState Pointer zum aktuellen State
  * @param[in] event Zu verarbeitendes Event
  */
@@ -174,14 +466,18 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
             break;
         case EVT_S2:
             turnDisplayOn();
-            lcd1602_write(1, "Sortiermodus:");
-            lcd1602_write(2, "S1: auto,S2: man");
+            lcd1602_show("Sortiermodus:", "S1: auto,S2: man");
             *currentState = MODE_SELECTION_STATE;
             break;
         case EVT_SYSTEM_TICK:
             timer_systick_stop();
             break;
-        case EVT_OBJECT_DETECTED:
+        case EVT_TASK:
+            pt_run();
+            break;
+        case EVT_UART:
+            command_process(currentState);
+            arm_standby_FSM(currentState);
             break;
         }
         break;
@@ -190,8 +486,7 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
         switch (event)
         {
         case EVT_S1:
-            turnDisplayOff();
-            *currentState = OFF_STATE;
+            enter_off(currentState);
             break;
         case EVT_S2:
             total_sorted = 0;
@@ -200,11 +495,16 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
             blue_sorted = 0;
 
             writeCurrentCount(total_sorted, blue_sorted, green_sorted, red_sorted);
+            checkpoint(*currentState);
             break;
         case EVT_SYSTEM_TICK:
             timer_systick_stop();
             break;
-        case EVT_OBJECT_DETECTED:
+        case EVT_TASK:
+            pt_run();
+            break;
+        case EVT_UART:
+            command_process(currentState);
             break;
         }
         break;
@@ -213,26 +513,19 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
         switch (event)
         {
         case EVT_S1:
-            lcd1602_clear();
-            plattform_default_position();
-            timer_systick_start();
-            calibrate_clear();
-            led_ready_on();
-            lcd1602_write(1, "Auto-Sort aktiv");
-            *currentState = AUTO_SORT_STATE;
+            enter_sort(currentState, AUTO_SORT_STATE);
             break;
-
         case EVT_S2:
-            lcd1602_clear();
-            plattform_default_position();
-            calibrate_clear();
-            led_ready_on();
-            lcd1602_write(1, "Manueller Modus");
-            *currentState = MANUAL_SORT_STATE;
+            enter_sort(currentState, MANUAL_SORT_STATE);
             break;
 
         case EVT_SYSTEM_TICK:
-        case EVT_OBJECT_DETECTED:
+            break;
+        case EVT_TASK:
+            pt_run();
+            break;
+        case EVT_UART:
+            command_process(currentState);
             break;
         }
         break;
@@ -243,17 +536,17 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
         case EVT_S1:
             break;
         case EVT_S2:
-            led_ready_off();
-            timer_systick_stop();
-            plattform_sleep_position();
-            turnDisplayOff();
-            *currentState = OFF_STATE;
+            stop_sort(currentState);
             break;
         case EVT_SYSTEM_TICK:
-            check_for_objects();
+            lane_start_all(false);
+            poll_tick();
+            break;
+        case EVT_TASK:
+            service_lanes(*currentState);
             break;
-        case EVT_OBJECT_DETECTED:
-            do_sort();
+        case EVT_UART:
+            command_process(currentState);
             break;
         }
         break;
@@ -262,19 +555,19 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
         switch (event)
         {
         case EVT_S1:
-            check_for_objects();
+            lane_start_all(true);
             break;
         case EVT_S2:
-            led_ready_off();
-            plattform_sleep_position();
-            turnDisplayOff();
-            *currentState = OFF_STATE;
+            stop_sort(currentState);
             break;
         case EVT_SYSTEM_TICK:
             timer_systick_stop();
             break;
-        case EVT_OBJECT_DETECTED:
-            do_sort();
+        case EVT_TASK:
+            service_lanes(*currentState);
+            break;
+        case EVT_UART:
+            command_process(currentState);
             break;
         }
         break;
@@ -282,7 +575,7 @@ void handleEvent_FSM(State_t *currentState, Event_t event)
 }
 
 #pragma vector = TIMER0_B1_VECTOR
-__interrupt void TIMER0_B1_ISR(void)
+RAMFUNC __interrupt void TIMER0_B1_ISR(void)
 {
     switch (__even_in_range(TB0IV, TB0IV_TBIFG))
     {
@@ -293,7 +586,7 @@ __interrupt void TIMER0_B1_ISR(void)
     case TB0IV_TBCCR2:
         break;
     case TB0IV_TBIFG:
-        eventBits |= EVT_SYSTEM_TICK;
+        EVENT_POST(EVT_SYSTEM_TICK);
         guiSysTickCnt++;
         break;
     default:
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "latency/latency.h"
 
 /**
  * @brief Events für die State Machine.
@@ -37,7 +38,8 @@
 #define EVT_SYSTEM_TICK BIT0     /**< System Tick für periodische Checks */
 #define EVT_S1 BIT1              /**< Button S1 wurde gedrückt */
 #define EVT_S2 BIT2              /**< Button S2 wurde gedrückt */
-#define EVT_OBJECT_DETECTED BIT3 /**< Object durch Color Sensor erkannt */
+#define EVT_TASK BIT3            /**< Task des Schedulers (pt) fällig */
+#define EVT_UART BIT4            /**< Befehlszeile über UART empfangen */
 
 /**
  * @brief States der Sortieranlage.
@@ -51,12 +53,32 @@ typedef enum
     DISPLAY_STATE         /**< Display der Sort Statistik */
 } State_t;
 
+/**
+ * @brief Setzt ein Event, auch aus ISRs.
+ *
+ * Steht das Event noch nicht aus, wird der Zeitpunkt für die
+ * Latenzmessung (latency.h) festgehalten.
+ */
+#define EVENT_POST(evt)                 \
+    do                                  \
+    {                                   \
+        if ((eventBits & (evt)) == 0)   \
+            latency_post(evt);          \
+        eventBits |= (evt);             \
+    } while (0)
+
 /** @brief Typdefinition für Events mit 16 Bit */
 typedef uint16_t Event_t;
 
 /** @brief Global Event Bits Variable für Event Handling */
 extern Event_t eventBits;
 
+/** @brief Sortier Statistik */
+extern uint8_t total_sorted;
+extern uint8_t red_sorted;
+extern uint8_t green_sorted;
+extern uint8_t blue_sorted;
+
 /**
  * @brief Handled State Transitions und Actions basierend auf Events.
  *
@@ -68,6 +90,49 @@ extern Event_t eventBits;
  */
 void handleEvent_FSM(State_t *currentState, Event_t event);
 
+/**
+ * @brief Wechselt ohne Knopfdruck in einen anderen Betriebsmodus.
+ *
+ * Ein laufender Sortiermodus wird zuerst wie mit S2 beendet. Der Wechsel
+ * in einen Sortiermodus entspricht der Moduswahl inklusive Kalibrierung.
+ *
+ * @param[in,out] currentState Pointer zum aktuellen State
+ * @param[in] target OFF_STATE, AUTO_SORT_STATE oder MANUAL_SORT_STATE
+ * @return false bei ungültigem Ziel oder fehlender Hardware
+ */
+bool switch_mode_FSM(State_t *currentState, State_t target);
+
+/**
+ * @brief Kalibriert die Lanes im laufenden Sortiermodus neu.
+ *
+ * @param[in] currentState Aktueller State
+ * @return false außerhalb eines Sortiermodus, solange eine Lane arbeitet oder
+ *         wenn die Messung einer Lane fehlgeschlagen ist
+ */
+bool calibrate_FSM(State_t currentState);
+
+/**
+ * @brief Setzt die Maschine nach einem Reset aus dem Snapshot im FRAM fort.
+ *
+ * Übernimmt Statistik und Kalibrierung. War beim letzten Snapshot ein
+ * Sortiermodus aktiv, wird er ohne Moduswahl und Kalibrierung fortgesetzt.
+ * Benötigt initialisierte Geräte und freigegebene Interrupts.
+ *
+ * @param[out] currentState Fortgesetzter State, bleibt sonst unverändert.
+ * @return true wenn ein Sortiermodus fortgesetzt wurde.
+ */
+bool resume_FSM(State_t *currentState);
+
+/**
+ * @brief Startet in OFF_STATE die Wartezeit bis zum Standby (standby.h).
+ *
+ * Ein erneuter Aufruf startet die Wartezeit von vorne, außerhalb von
+ * OFF_STATE passiert nichts.
+ *
+ * @param[in] currentState Pointer zum aktuellen State, muss gültig bleiben.
+ */
+void arm_standby_FSM(State_t *currentState);
+
 /**
  * @brief Extrahiert das nächste pending Event aus den Event Bits.
  *
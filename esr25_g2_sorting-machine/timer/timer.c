@@ -1,10 +1,17 @@
 #include "timer/timer.h"
+#include "power/power.h"
+#include "ramfunc/ramfunc.h"
 #include <msp430.h>
 
 uint16_t guiSysTickCnt = 0;
 static uint16_t muiSysTickPer_ms = 1000;
 static uint16_t muiUpCnt = 0x7FFF;
 static volatile bool timer1_done = false;
+static volatile bool timeout_expired = false;
+static volatile timer_alarm_handler_t alarm_handler = 0;
+
+/** @brief Überläufe von Timer_B3, obere Hälfte von timer_stamp32(). */
+static volatile uint16_t stamp_hi = 0;
 
 void timer_init(void)
 {
@@ -16,6 +23,10 @@ void timer_init(void)
     // Timer_B1 für Sleep-Funktionalität konfigurieren
     TB1CTL = TBSSEL__ACLK | ID__2 | MC__STOP | TBCLR; // ACLK, stoppen, löschen
     TB1CCTL0 = CCIE;                                  // CCR0 Interrupt aktivieren
+
+    // Timer_B3 als freilaufenden Zeitstempel starten
+    // Überlauf alle 16 s erweitert den Zeitstempel auf 32 Bit
+    TB3CTL = TBSSEL__ACLK | ID__8 | MC__CONTINUOUS | TBCLR | TBIE; // ACLK / 8, continuous
 }
 
 void timer_sleep_ms(uint16_t sleep_ms)
@@ -39,13 +50,27 @@ void timer_sleep_ms(uint16_t sleep_ms)
 
      while (!timer1_done)
      {
-        LPM3;                  // Schlafen bis CCR0 ISR
+        power_sleep(POWER_LPM3); // Schlafen bis CCR0 ISR
      }
     
     TB1CTL &= ~MC__UP;     // Timer_B1 stoppen
     TB1CTL |= MC__STOP;
 }
 
+void timer_cycles_start(void)
+{
+    TB1CTL = TBSSEL__SMCLK | MC__CONTINUOUS | TBCLR;
+}
+
+uint16_t timer_cycles_stop(void)
+{
+    uint16_t cycles = TB1R; // synchron zur CPU, einmal lesen genügt
+
+    TB1CTL = TBSSEL__ACLK | ID__2 | MC__STOP | TBCLR;
+    TB1CCTL0 &= ~CCIFG; // Vergleich mit CCR0 während der Zählung verwerfen
+    return cycles;
+}
+
 void timer_systick_init(uint32_t period_ms)
 {
     muiSysTickPer_ms = period_ms;
@@ -55,6 +80,25 @@ void timer_systick_init(uint32_t period_ms)
     muiUpCnt = (uint16_t)(ulUpCnt - 1);
 }
 
+void timer_systick_set_period(uint16_t period_ms)
+{
+    if (period_ms > TIMER_SYSTICK_MAX_MS)
+        period_ms = TIMER_SYSTICK_MAX_MS;
+    if (period_ms == 0)
+        period_ms = 1;
+
+    muiSysTickPer_ms = period_ms;
+    muiUpCnt = (uint16_t)((((uint32_t)period_ms * 32768UL) / 1000UL) - 1);
+
+    if ((TB0CTL & MC__UP) == 0)
+        return;
+
+    TB0CCR0 = muiUpCnt;
+    // Zähler bereits hinter der neuen Periode → sonst erst nach Überlauf
+    if (TB0R >= muiUpCnt)
+        TB0CTL |= TBCLR;
+}
+
 void timer_systick_start(void)
 {
     guiSysTickCnt = 0;
@@ -74,10 +118,104 @@ void timer_systick_sleep(uint32_t sleep_ms)
     while (pause_cnt > 0)
     {
         pause_cnt--;
-        LPM3;
+        power_sleep(POWER_LPM3);
+    }
+}
+
+RAMFUNC uint16_t timer_stamp(void)
+{
+    uint16_t a, b;
+
+    // Timer läuft asynchron zur CPU, daher bis zwei gleiche Werte gelesen werden
+    do
+    {
+        a = TB3R;
+        b = TB3R;
+    } while (a != b);
+
+    return a;
+}
+
+uint32_t timer_stamp32(void)
+{
+    uint16_t hi, lo;
+    bool pending;
+
+    // Erneut lesen, falls die ISR zwischen den Zugriffen den Überlauf zählt
+    do
+    {
+        hi = stamp_hi;
+        lo = timer_stamp();
+        pending = (TB3CTL & TBIFG) != 0;
+    } while (hi != stamp_hi);
+
+    // Überlauf vor dem Lesen von lo, aber ISR noch nicht gelaufen
+    if (pending && lo < 0x8000)
+        hi++;
+
+    return ((uint32_t)hi << 16) | lo;
+}
+
+uint16_t timer_stamp_to_ms(uint16_t ticks)
+{
+    // ms = ticks × 1000 / 4096 = ticks × 125 / 512
+    return (uint16_t)(((uint32_t)ticks * 125UL) >> 9);
+}
+
+uint32_t timer_stamp32_to_ms(uint32_t ticks)
+{
+    // Aufgeteilt, damit ticks × 125 nicht überläuft
+    return (ticks >> 9) * 125UL + (((ticks & 0x1FF) * 125UL) >> 9);
+}
+
+uint16_t timer_ms_to_stamp(uint16_t ms)
+{
+    // ms in Ticks des Zeitstempels umwandeln (4.096 Hz)
+    return (uint16_t)(((uint32_t)ms * TIMER_STAMP_HZ) / 1000UL);
+}
+
+void timer_timeout_start(uint16_t timeout_ms)
+{
+    uint16_t ticks = timer_ms_to_stamp(timeout_ms);
+
+    if (ticks == 0)
+        ticks = 1;
+
+    timeout_expired = false;
+    TB3CCR1 = timer_stamp() + ticks;
+    TB3CCTL1 = CCIE; // CCIFG löschen, Interrupt aktivieren
+}
+
+bool timer_timeout_expired(void)
+{
+    return timeout_expired;
+}
+
+void timer_timeout_stop(void)
+{
+    TB3CCTL1 = 0;
+}
+
+void timer_alarm_at(uint16_t stamp, timer_alarm_handler_t handler)
+{
+    alarm_handler = handler;
+    TB3CCR2 = stamp;
+    TB3CCTL2 = CCIE; // CCIFG löschen, Interrupt aktivieren
+
+    // Weckzeit bereits verstrichen → der Vergleich würde erst nach einem
+    // vollen Timerumlauf auslösen
+    if ((int16_t)(stamp - timer_stamp()) <= 0)
+    {
+        TB3CCTL2 = 0;
+        handler();
     }
 }
 
+void timer_alarm_stop(void)
+{
+    TB3CCTL2 = 0;
+}
+
 /* ========================================================================== */
 /* Interrupt Service Routines                                                 */
 /* ========================================================================== */
@@ -91,3 +229,34 @@ __interrupt void TIMER1_B0_ISR(void)
     timer1_done = true;
     __bic_SR_register_on_exit(LPM3_bits); // LPM3 verlassen
 }
+
+/**
+ * @brief Timer_B3 CCR1-CCR6/Overflow Interrupt Service Routine.
+ *
+ * CCR1: Timeout-Überwachung abgelaufen → LPM3 verlassen.
+ * CCR2: Weckzeit erreicht → Handler aufrufen, LPM3 verlassen.
+ * Überlauf: obere Hälfte des 32 Bit Zeitstempels zählen, CPU schläft weiter.
+ */
+#pragma vector = TIMER3_B1_VECTOR
+RAMFUNC __interrupt void TIMER3_B1_ISR(void)
+{
+    switch (__even_in_range(TB3IV, TB3IV_TBIFG))
+    {
+    case TB3IV_TBCCR1:
+        TB3CCTL1 &= ~CCIE;
+        timeout_expired = true;
+        __bic_SR_register_on_exit(LPM3_bits);
+        break;
+    case TB3IV_TBCCR2:
+        TB3CCTL2 &= ~CCIE;
+        if (alarm_handler)
+            alarm_handler();
+        __bic_SR_register_on_exit(LPM3_bits);
+        break;
+    case TB3IV_TBIFG:
+        stamp_hi++;
+        break;
+    default:
+        break;
+    }
+}
@@ -11,7 +11,11 @@
  * Dieses Modul kombiniert Timer-basierte Verzögerungsfunktionen mit
  * System-Tick-Funktionalität für State-Machine-Anwendungen.
  * - Timer_B0: System-Tick (ACLK / 2 = 16.384 Hz)
- * - Timer_B1: Sleep-Funktionalität (ACLK / 2 = 16.384 Hz)
+ * - Timer_B1: Sleep-Funktionalität (ACLK / 2 = 16.384 Hz), außerhalb davon
+ *             Zyklenzählung mit SMCLK
+ * - Timer_B3: Freilaufender Zeitstempel (ACLK / 8 = 4.096 Hz), der
+ *             Überlauf erweitert ihn auf 32 Bit, CCR1 als
+ *             Timeout-Überwachung, CCR2 als Weckzeit
  */
 
 #ifndef TIMER_TIMER_H_
@@ -26,6 +30,23 @@
 
 extern uint16_t guiSysTickCnt;
 
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Taktfrequenz des freilaufenden Zeitstempels (ACLK / 8). */
+#define TIMER_STAMP_HZ 4096U
+
+/** @brief Längste System-Tick Periode (16-Bit Zähler an ACLK). */
+#define TIMER_SYSTICK_MAX_MS 2000U
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/** @brief Wird beim Erreichen der Weckzeit im Interrupt-Kontext aufgerufen. */
+typedef void (*timer_alarm_handler_t)(void);
+
 /* ========================================================================== */
 /* Timer Funktionen                                                           */
 /* ========================================================================== */
@@ -44,6 +65,20 @@ void timer_init(void);
  */
 void timer_sleep_ms(uint16_t sleep_ms);
 
+/**
+ * @brief Startet die Zyklenzählung auf Timer_B1 (SMCLK = MCLK).
+ *
+ * Nicht während timer_sleep_ms() verwenden.
+ */
+void timer_cycles_start(void);
+
+/**
+ * @brief Beendet die Zyklenzählung und stellt Timer_B1 für timer_sleep_ms() her.
+ *
+ * @return MCLK-Zyklen seit timer_cycles_start() (max. 65535).
+ */
+uint16_t timer_cycles_stop(void);
+
 /**
  * @brief Initialisiert den System-Tick mit gegebener Periode.
  *
@@ -51,6 +86,16 @@ void timer_sleep_ms(uint16_t sleep_ms);
  */
 void timer_systick_init(uint32_t period_ms);
 
+/**
+ * @brief Ändert die Periode des System-Ticks, auch während er läuft.
+ *
+ * Ist der laufende Zähler bereits über der neuen Periode, beginnt die
+ * Periode neu.
+ *
+ * @param[in] period_ms Tick-Periode in Millisekunden (1-TIMER_SYSTICK_MAX_MS).
+ */
+void timer_systick_set_period(uint16_t period_ms);
+
 /**
  * @brief Startet den System-Tick auf Timer_B0.
  */
@@ -68,4 +113,90 @@ void timer_systick_stop(void);
  */
 void timer_systick_sleep(uint32_t sleep_ms);
 
+/**
+ * @brief Liefert den aktuellen Stand des freilaufenden Zeitstempels.
+ *
+ * Timer_B3 läuft im Continuous Mode mit 4.096 Hz und läuft alle 16 s über.
+ * Differenzen zweier Zeitstempel sind daher bis 16 s gültig.
+ *
+ * @return Zeitstempel in Timer-Ticks.
+ */
+uint16_t timer_stamp(void);
+
+/**
+ * @brief Liefert den auf 32 Bit erweiterten Zeitstempel.
+ *
+ * Die oberen 16 Bit zählen die Überläufe von Timer_B3 seit dem Start. Der
+ * Zeitstempel ist monoton und läuft erst nach gut 12 Tagen über, Differenzen
+ * sind bis dahin gültig. Ohne Sperren lesbar, auch aus ISRs und bei
+ * gesperrten Interrupts: ein noch nicht behandelter Überlauf wird über
+ * das anstehende TBIFG berücksichtigt.
+ *
+ * @return Zeitstempel in Timer-Ticks.
+ */
+uint32_t timer_stamp32(void);
+
+/**
+ * @brief Rechnet eine Zeitstempel-Differenz in Millisekunden um.
+ *
+ * @param[in] ticks Differenz zweier Zeitstempel in Timer-Ticks.
+ * @return Zeitspanne in ms.
+ */
+uint16_t timer_stamp_to_ms(uint16_t ticks);
+
+/**
+ * @brief Rechnet eine Differenz von 32 Bit Zeitstempeln in Millisekunden um.
+ *
+ * @param[in] ticks Differenz zweier Zeitstempel in Timer-Ticks.
+ * @return Zeitspanne in ms.
+ */
+uint32_t timer_stamp32_to_ms(uint32_t ticks);
+
+/**
+ * @brief Startet die Timeout-Überwachung auf Timer_B3 CCR1.
+ *
+ * Nach Ablauf wird timer_timeout_expired() wahr und ein LPM verlassen,
+ * sodass blockierende Warteschleifen abgebrochen werden können.
+ *
+ * @param[in] timeout_ms Timeout in ms (1-15999).
+ */
+void timer_timeout_start(uint16_t timeout_ms);
+
+/**
+ * @brief Prüft, ob der laufende Timeout abgelaufen ist.
+ *
+ * @return true wenn der Timeout abgelaufen ist.
+ */
+bool timer_timeout_expired(void);
+
+/**
+ * @brief Beendet die Timeout-Überwachung.
+ */
+void timer_timeout_stop(void);
+
+/**
+ * @brief Rechnet Millisekunden in Ticks des Zeitstempels um.
+ *
+ * @param[in] ms Zeitspanne in ms (0-15999).
+ * @return Zeitspanne in Timer-Ticks.
+ */
+uint16_t timer_ms_to_stamp(uint16_t ms);
+
+/**
+ * @brief Setzt die Weckzeit auf Timer_B3 CCR2.
+ *
+ * Erreicht der Zeitstempel @p stamp, wird @p handler aufgerufen und ein
+ * LPM verlassen. Liegt @p stamp bereits in der Vergangenheit, wird
+ * @p handler sofort aufgerufen. Eine vorherige Weckzeit wird ersetzt.
+ *
+ * @param[in] stamp   Zeitstempel der Weckzeit (höchstens 8 s in der Zukunft).
+ * @param[in] handler Aufzurufende Funktion.
+ */
+void timer_alarm_at(uint16_t stamp, timer_alarm_handler_t handler);
+
+/**
+ * @brief Löscht die gesetzte Weckzeit.
+ */
+void timer_alarm_stop(void);
+
 #endif /* TIMER_TIMER_H_ */
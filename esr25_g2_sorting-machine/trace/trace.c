@@ -0,0 +1,83 @@
+/* ========================================================================== */
+/* trace.c                                                                    */
+/* ========================================================================== */
+/**
+ * @file      trace.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung des Sortier-Trace im FRAM.
+ */
+
+#include "trace.h"
+#include "fram/fram.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Speicherlayout des Trace im FRAM.
+ *
+ * @c head zählt alle jemals geschriebenen Einträge. Nach 0xFFFF wird auf
+ * TRACE_DEPTH statt 0 weitergezählt, damit der Puffer voll bleibt und der
+ * Slot-Index (head % TRACE_DEPTH) fortlaufend ist.
+ */
+typedef struct
+{
+    uint16_t magic;                       /**< TRACE_MAGIC bei gültigem Inhalt */
+    uint16_t head;                        /**< Anzahl geschriebener Einträge */
+    trace_entry_t entries[TRACE_DEPTH];   /**< Ringpuffer */
+} trace_log_t;
+
+/**
+ * volatile, damit der Compiler den Eintrag nicht hinter das Weiterzählen
+ * von head verschiebt und die Reihenfolge über einen Reset hinweg gilt.
+ */
+#pragma PERSISTENT(trace_log)
+volatile trace_log_t trace_log = { 0 };
+
+void trace_init(void)
+{
+    if (trace_log.magic != TRACE_MAGIC)
+    {
+        trace_clear();
+    }
+}
+
+void trace_append(const trace_entry_t *entry)
+{
+    uint16_t head = trace_log.head;
+    uint16_t wp = fram_unlock();
+
+    trace_log.entries[head & (TRACE_DEPTH - 1)] = *entry;
+
+    // Einzige Indexänderung macht den Eintrag gültig
+    trace_log.head = (head == 0xFFFF) ? TRACE_DEPTH : (uint16_t)(head + 1);
+
+    fram_lock(wp);
+}
+
+uint16_t trace_count(void)
+{
+    return (trace_log.head < TRACE_DEPTH) ? trace_log.head : TRACE_DEPTH;
+}
+
+bool trace_read(uint16_t age, trace_entry_t *entry)
+{
+    if (age >= trace_count())
+    {
+        return false;
+    }
+
+    *entry = trace_log.entries[(trace_log.head - 1 - age) & (TRACE_DEPTH - 1)];
+    return true;
+}
+
+void trace_clear(void)
+{
+    uint16_t wp = fram_unlock();
+
+    trace_log.head = 0;
+    trace_log.magic = TRACE_MAGIC;
+
+    fram_lock(wp);
+}
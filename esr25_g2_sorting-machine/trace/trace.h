@@ -0,0 +1,123 @@
+/* ========================================================================== */
+/* trace.h                                                                    */
+/* ========================================================================== */
+/**
+ * @file      trace.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Sortier-Trace im FRAM zur Offline-Analyse.
+ *
+ * Für jedes sortierte Objekt wird ein kompakter Eintrag in einem
+ * Ringpuffer im FRAM abgelegt:
+ *   - C/R/G/B des Farbsensors abzüglich Umgebungslicht
+ *   - Klassifikation, Konfidenz und gewählter Ausgang
+ *   - Dauer von Messung und Entleeren (zusammen der Zyklus ab Objekterkennung)
+ *
+ * Ein Eintrag wird zuerst vollständig geschrieben, danach wird nur der
+ * Schreibindex erhöht. Ein Reset während des Schreibens verwirft daher
+ * höchstens den unvollständigen Eintrag.
+ *
+ * Auslesen:
+ *   - Zur Laufzeit über trace_count() und trace_read()
+ *   - Über den Debugger als Speicherabbild des Symbols @c trace_log
+ *     (Auswertung mit tools/trace_decode.py)
+ */
+
+#ifndef TRACE_TRACE_H_
+#define TRACE_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Anzahl der Einträge im Ringpuffer (Zweierpotenz, 16 Byte je Eintrag). */
+#define TRACE_DEPTH   256U
+
+/** @brief Kennung des Speicherlayouts, wird bei Layoutänderung erhöht. */
+#define TRACE_MAGIC   0x5452U
+
+/** @brief Flag: Sortierung wurde manuell ausgelöst. */
+#define TRACE_FLAG_MANUAL  0x01U
+
+/** @brief Flag: Objekt lag nach dem ersten Kippen noch auf der Plattform. */
+#define TRACE_FLAG_RETRY   0x02U
+
+/** @brief Flag: Objekt lag auch nach der Wiederholung noch auf der Plattform. */
+#define TRACE_FLAG_STUCK   0x04U
+
+/** @brief Flag: Richtungsservo stand bereits auf der erkannten Farbe. */
+#define TRACE_FLAG_PREDICTED 0x08U
+
+/** @brief Bitposition der Lane-Nummer in den Flags (Bits 4-7). */
+#define TRACE_FLAG_LANE_SHIFT 4
+
+/** @brief Flags-Anteil für die Lane @p id. */
+#define TRACE_FLAG_LANE(id) ((uint8_t)((id) << TRACE_FLAG_LANE_SHIFT))
+
+/* ========================================================================== */
+/* Typen                                                                      */
+/* ========================================================================== */
+
+/**
+ * @brief Ein Trace-Eintrag pro sortiertem Objekt (16 Byte).
+ */
+typedef struct
+{
+    uint16_t clear;        /**< Clear-Kanal ohne Umgebungslicht */
+    uint16_t red;          /**< Rot-Kanal ohne Umgebungslicht */
+    uint16_t green;        /**< Grün-Kanal ohne Umgebungslicht */
+    uint16_t blue;         /**< Blau-Kanal ohne Umgebungslicht */
+    uint8_t  color;        /**< Erkannte Farbe (COLOR) */
+    uint8_t  confidence;   /**< Abstand dominanter zu zweitem Kanal (0-255) */
+    uint8_t  bin;          /**< Angefahrener Ausgang */
+    uint8_t  flags;        /**< TRACE_FLAG_* */
+    uint16_t t_measure_ms; /**< Dauer der Farbmessung */
+    uint16_t t_empty_ms;   /**< Dauer des Entleerens */
+} trace_entry_t;
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Prüft das Speicherlayout und setzt den Trace bei Bedarf zurück.
+ *
+ * Muss einmal beim Systemstart aufgerufen werden.
+ */
+void trace_init(void);
+
+/**
+ * @brief Hängt einen Eintrag an den Ringpuffer an.
+ *
+ * Der älteste Eintrag wird überschrieben, sobald der Puffer voll ist.
+ *
+ * @param[in] entry Zu speichernder Eintrag.
+ */
+void trace_append(const trace_entry_t *entry);
+
+/**
+ * @brief Liefert die Anzahl der gültigen Einträge.
+ *
+ * @return Anzahl gültiger Einträge (0 bis TRACE_DEPTH).
+ */
+uint16_t trace_count(void);
+
+/**
+ * @brief Liest einen Eintrag aus dem Ringpuffer.
+ *
+ * @param[in]  age   Alter des Eintrags (0 = neuester Eintrag).
+ * @param[out] entry Zielpuffer für den Eintrag.
+ * @return true wenn der Eintrag existiert, sonst false.
+ */
+bool trace_read(uint16_t age, trace_entry_t *entry);
+
+/**
+ * @brief Löscht alle Einträge.
+ */
+void trace_clear(void);
+
+#endif /* TRACE_TRACE_H_ */
@@ -0,0 +1,161 @@
+/* ========================================================================== */
+/* uart.c                                                                     */
+/* ========================================================================== */
+/**
+ * @file      uart.c
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Implementierung der zeilenorientierten UART.
+ */
+
+#include "uart.h"
+#include "state_machine/state_machine.h"
+#include "timer/timer.h"
+#include <msp430.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+extern Event_t eventBits;
+
+/**
+ * @brief Sendepuffer. Mit 256 Byte und 8 Bit Indizes läuft der Ring ohne
+ *        Modulo über, tx_head schreibt nur uart_write(), tx_tail nur die ISR.
+ */
+static char tx_buf[256];
+static volatile uint8_t tx_head = 0;
+static volatile uint8_t tx_tail = 0;
+
+/** @brief Empfangspuffer der aktuellen Zeile. */
+static char rx_line[UART_LINE_LEN + 1];
+static uint8_t rx_len = 0;
+
+/** @brief Zeile ist vollständig und wartet auf uart_read_line(). */
+static volatile bool rx_ready = false;
+
+/** @brief Aktuelle Zeile war zu lang und wird verworfen. */
+static bool rx_overflow = false;
+
+/** @brief timer_stamp32() der zuletzt abgeholten Zeile. */
+static uint32_t rx_stamp = 0;
+
+/** @brief Seit dem Start wurde eine Zeile abgeholt. */
+static bool rx_seen = false;
+
+void uart_init(void)
+{
+    UCA1CTLW0 = UCSWRST;
+    UCA1CTLW0 |= UCSSEL__ACLK;
+
+    // 32768 Hz / 9600 Baud = 3.41 → UCBRx = 3, UCBRSx = 0x92, ohne Oversampling
+    UCA1BRW = 3;
+    UCA1MCTLW = 0x9200;
+
+    // P4.2 RXD, P4.3 TXD (primäre Funktion)
+    P4SEL0 |= BIT2 | BIT3;
+    P4SEL1 &= ~(BIT2 | BIT3);
+
+    UCA1CTLW0 &= ~UCSWRST;
+    UCA1IE |= UCRXIE;
+}
+
+bool uart_read_line(char *line)
+{
+    if (!rx_ready)
+        return false;
+
+    memcpy(line, rx_line, rx_len + 1);
+    rx_len = 0;
+    rx_ready = false;
+
+    rx_stamp = timer_stamp32();
+    rx_seen = true;
+    return true;
+}
+
+uint32_t uart_idle_ticks(void)
+{
+    if (!rx_seen)
+        return UINT32_MAX;
+
+    return timer_stamp32() - rx_stamp;
+}
+
+bool uart_write(const char *text)
+{
+    uint16_t len = strlen(text);
+    uint8_t head = tx_head;
+    uint16_t i;
+
+    // Ein Platz bleibt frei, sonst wäre voll nicht von leer zu unterscheiden
+    if (len > 255U - (uint8_t)(head - tx_tail))
+        return false;
+
+    for (i = 0; i < len; i++)
+        tx_buf[head++] = text[i];
+
+    tx_head = head;
+    UCA1IE |= UCTXIE;
+    return true;
+}
+
+/**
+ * @brief Nimmt ein empfangenes Zeichen in die aktuelle Zeile auf.
+ *
+ * @return true wenn die Zeile damit vollständig ist.
+ */
+static bool receive(char c)
+{
+    if (rx_ready)
+        return false;
+
+    if (c == '\r' || c == '\n')
+    {
+        if (rx_overflow || rx_len == 0)
+        {
+            rx_overflow = false;
+            rx_len = 0;
+            return false;
+        }
+        rx_line[rx_len] = '\0';
+        rx_ready = true;
+        return true;
+    }
+
+    if (rx_len < UART_LINE_LEN)
+        rx_line[rx_len++] = c;
+    else
+        rx_overflow = true;
+
+    return false;
+}
+
+/**
+ * @brief ISR des eUSCI_A1.
+ */
+#pragma vector = EUSCI_A1_VECTOR
+__interrupt void EUSCI_A1_UART_ISR(void)
+{
+    switch (__even_in_range(UCA1IV, USCI_UART_UCTXCPTIFG))
+    {
+    case USCI_UART_UCRXIFG:
+        if (receive((char)UCA1RXBUF))
+        {
+            EVENT_POST(EVT_UART);
+            __bic_SR_register_on_exit(LPM3_bits);
+        }
+        break;
+    case USCI_UART_UCTXIFG:
+        if (tx_tail == tx_head)
+        {
+            UCA1IE &= ~UCTXIE;
+            break;
+        }
+        UCA1TXBUF = tx_buf[tx_tail];
+        tx_tail++;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,70 @@
+/* ========================================================================== */
+/* uart.h                                                                     */
+/* ========================================================================== */
+/**
+ * @file      uart.h
+ * @author    agent
+ * @date      19.10.2026
+ *
+ * @brief     Zeilenorientierte UART über den Backchannel des LaunchPads.
+ *
+ * eUSCI_A1 (P4.2 RXD, P4.3 TXD) läuft mit 9600 Baud aus dem ACLK. Damit
+ * bleibt die Baudrate bei jedem Taktprofil gleich und die Schnittstelle
+ * empfängt auch in LPM3.
+ *
+ * Empfang und Senden laufen vollständig in der ISR:
+ *   - Empfangene Zeichen werden bis zum Zeilenende ('\\r' oder '\\n')
+ *     gesammelt, danach setzt die ISR EVT_UART. Bis die Zeile mit
+ *     uart_read_line() abgeholt ist, werden weitere Zeichen verworfen.
+ *   - uart_write() legt Text in einen Ringpuffer und kehrt sofort zurück.
+ *     Passt der Text nicht vollständig hinein, wird er verworfen.
+ */
+
+#ifndef UART_UART_H_
+#define UART_UART_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ========================================================================== */
+/* Konstanten                                                                 */
+/* ========================================================================== */
+
+/** @brief Maximale Länge einer empfangenen Zeile ohne Zeilenende. */
+#define UART_LINE_LEN 32
+
+/* ========================================================================== */
+/* Funktionen                                                                 */
+/* ========================================================================== */
+
+/**
+ * @brief Konfiguriert eUSCI_A1 und die Pins und gibt den Empfang frei.
+ */
+void uart_init(void);
+
+/**
+ * @brief Holt eine vollständig empfangene Zeile ab.
+ *
+ * @param[out] line Puffer mit mindestens UART_LINE_LEN + 1 Zeichen,
+ *                  nullterminiert ohne Zeilenende.
+ * @return true wenn eine Zeile vorlag.
+ */
+bool uart_read_line(char *line);
+
+/**
+ * @brief Sendet einen nullterminierten Text ohne zu warten.
+ *
+ * @param[in] text Text.
+ * @return false wenn der Sendepuffer zu voll war, der Text wurde verworfen.
+ */
+bool uart_write(const char *text);
+
+/**
+ * @brief Liefert die Zeit seit der zuletzt abgeholten Zeile.
+ *
+ * @return Zeit in Ticks von timer_stamp32(), UINT32_MAX wenn seit dem
+ *         Start keine Zeile empfangen wurde.
+ */
+uint32_t uart_idle_ticks(void);
+
+#endif /* UART_UART_H_ */
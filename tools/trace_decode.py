@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+"""Dekodiert ein Binärabbild von trace_log (trace/trace.c) als CSV.
+
+Aufruf: python trace_decode.py trace_log.bin > trace.csv
+
+Die Einträge werden vom ältesten zum neuesten ausgegeben.
+"""
+
+import struct
+import sys
+
+TRACE_DEPTH = 256
+TRACE_MAGIC = 0x5452
+TRACE_FLAG_LANE_SHIFT = 4
+ENTRY = struct.Struct("<4H4B2H")
+COLORS = {0: "RED", 1: "BLUE", 2: "GREEN", 3: "UNKNOWN"}
+
+
+def main(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, head = struct.unpack_from("<2H", data, 0)
+    if magic != TRACE_MAGIC:
+        sys.exit("ungültiges Abbild (magic 0x%04X)" % magic)
+
+    count = min(head, TRACE_DEPTH)
+    print("seq,lane,clear,red,green,blue,color,confidence,bin,flags,t_measure_ms,t_empty_ms")
+    for age in range(count - 1, -1, -1):
+        slot = (head - 1 - age) % TRACE_DEPTH
+        c, r, g, b, color, conf, bin_, flags, t_meas, t_empty = ENTRY.unpack_from(
+            data, 4 + slot * ENTRY.size)
+        print("%d,%d,%d,%d,%d,%d,%s,%d,%d,%d,%d,%d" % (
+            count - 1 - age, flags >> TRACE_FLAG_LANE_SHIFT, c, r, g, b,
+            COLORS.get(color, color), conf, bin_,
+            flags, t_meas, t_empty))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+    main(sys.argv[1])
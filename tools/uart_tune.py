@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""Abstimmen und Auslesen der Sortieranlage über die UART (command/command.h).
+
+Aufruf:
+  python uart_tune.py PORT list
+  python uart_tune.py PORT get NAME
+  python uart_tune.py PORT set NAME WERT
+  python uart_tune.py PORT defaults
+  python uart_tune.py PORT counters
+  python uart_tune.py PORT stats
+  python uart_tune.py PORT trace [ANZAHL]
+  python uart_tune.py PORT mode auto|manual|off
+  python uart_tune.py PORT calibrate
+  python uart_tune.py PORT latency [reset]
+  python uart_tune.py PORT energy [reset]
+  python uart_tune.py PORT bench
+  python uart_tune.py PORT sweep NAME START STOP SCHRITT [OBJEKTE]
+
+NAME ist ein Feld von config_t (config/config.h) oder dessen Index.
+
+sweep setzt den Parameter nacheinander auf jeden Wert, wartet im Auto-Modus
+auf OBJEKTE (Standard 10) sortierte Objekte und gibt den Durchsatz als CSV
+aus. Benötigt pyserial.
+"""
+
+import sys
+import time
+
+import serial
+
+BAUD = 9600
+TIMEOUT_S = 2.0
+
+# Reihenfolge der Felder in config_t
+FIELDS = [
+    "version",
+    "aim_ms", "empty_ms", "level_ms", "empty_min_ms",
+    "pulse_red", "pulse_green", "pulse_blue", "pulse_reject",
+    "pulse_level", "pulse_tilt", "pulse_sleep",
+    "detect_pct", "empty_pct", "min_confidence",
+    "poll_fast_ms", "poll_slow_ms",
+    "active_ua_mhz", "lpm0_ua", "lpm3_ua", "base_ua", "supply_mv",
+    "standby_s",
+    "crc",
+]
+
+EVENTS = ["SYSTEM_TICK", "S1", "S2", "TASK", "UART"]
+TICK_MS = 1000.0 / 4096
+
+STATES = {0: "OFF", 1: "MODE_SELECTION", 2: "AUTO", 3: "MANUAL", 4: "DISPLAY"}
+COLORS = {0: "RED", 1: "BLUE", 2: "GREEN", 3: "UNKNOWN"}
+
+
+class Machine:
+    """Eine Befehlszeile senden, eine Antwortzeile lesen."""
+
+    def __init__(self, port):
+        self.port = serial.Serial(port, BAUD, timeout=TIMEOUT_S)
+        self.port.reset_input_buffer()
+
+    def read_line(self):
+        line = self.port.readline().decode("ascii").strip()
+        if not line:
+            raise RuntimeError("keine Antwort")
+        return line
+
+    def command(self, text):
+        self.port.write((text + "\n").encode("ascii"))
+        reply = self.read_line().split()
+        if reply[0] == "e" or reply[0] != text[0]:
+            raise RuntimeError("Befehl abgelehnt: " + text)
+        return [int(v) for v in reply[1:]]
+
+    def get(self, index):
+        return self.command("g %d" % index)[1]
+
+    def set(self, index, value):
+        return self.command("s %d %d" % (index, value))[1]
+
+    def counters(self):
+        return self.command("c")
+
+    def stats(self):
+        self.port.write(b"i\n")
+        rows = []
+        while True:
+            reply = self.read_line().split()
+            if len(reply) == 1:
+                return rows
+            rows.append([int(v) for v in reply[1:]])
+
+
+def field_index(name):
+    if name.isdigit():
+        return int(name)
+    return FIELDS.index(name)
+
+
+def sweep(machine, index, start, stop, step, objects):
+    machine.command("m a")
+    print("%s,objects,seconds,objects_per_min" % FIELDS[index])
+    for value in range(start, stop + 1, step):
+        machine.set(index, value)
+        total = machine.counters()[0]
+        begin = time.monotonic()
+        while (machine.counters()[0] - total) % 256 < objects:
+            time.sleep(0.5)
+        seconds = time.monotonic() - begin
+        print("%d,%d,%.1f,%.1f" % (value, objects, seconds, objects * 60.0 / seconds))
+        sys.stdout.flush()
+
+
+def main(argv):
+    if len(argv) < 3:
+        sys.exit(__doc__)
+
+    machine = Machine(argv[1])
+    cmd, args = argv[2], argv[3:]
+
+    if cmd == "list":
+        for name, value in zip(FIELDS, machine.command("l")):
+            print("%-15s %d" % (name, value))
+    elif cmd == "get":
+        print(machine.get(field_index(args[0])))
+    elif cmd == "set":
+        print(machine.set(field_index(args[0]), int(args[1])))
+    elif cmd == "defaults":
+        machine.command("d")
+    elif cmd == "counters":
+        total, red, green, blue = machine.counters()
+        print("total=%d red=%d green=%d blue=%d" % (total, red, green, blue))
+    elif cmd == "stats":
+        boot_ms, poll_ms, traces, state, uptime_s = machine.command("p")
+        print("boot_ms=%d poll_ms=%d traces=%d state=%s uptime_s=%d" % (
+            boot_ms, poll_ms, traces, STATES.get(state, state), uptime_s))
+        util = machine.command("u")
+        busy = util[2:]
+        for bus, addr, nack, timeout, clear, failed, transfers, size, ticks in machine.stats():
+            print("bus%d 0x%02X nack=%d timeout=%d bus_clear=%d failed=%d "
+                  "transfers=%d bytes=%d busy_ms=%.0f share=%.0f%%" % (
+                      bus, addr, nack, timeout, clear, failed, transfers, size,
+                      ticks * TICK_MS, 100.0 * ticks / busy[bus] if busy[bus] else 0))
+        for bus in (0, 1):
+            print("bus%d utilization=%d%% busy_ms=%.0f" % (bus, util[bus], busy[bus] * TICK_MS))
+    elif cmd == "trace":
+        count = int(args[0]) if args else machine.command("p")[2]
+        print("age,lane,clear,red,green,blue,color,confidence,bin,flags,t_measure_ms,t_empty_ms")
+        for age in range(count):
+            e = machine.command("t %d" % age)
+            e[6] = COLORS.get(e[6], e[6])
+            print(",".join(str(v) for v in e))
+    elif cmd == "mode":
+        target = {"auto": "a", "manual": "m", "off": "o"}[args[0]]
+        print(STATES[machine.command("m " + target)[0]])
+    elif cmd == "calibrate":
+        machine.command("k")
+    elif cmd == "latency":
+        if args and args[0] == "reset":
+            machine.command("v")
+            return
+        print("event,kind,count,min_ms,max_ms," +
+              ",".join("lt%.0fms" % (4 ** (k + 1) * TICK_MS) for k in range(7)) + ",rest")
+        for index, name in enumerate(EVENTS):
+            for kind in (0, 1):
+                count, low, high, *hist = machine.command("v %d %d" % (index, kind))[2:]
+                print("%s,%s,%d,%.2f,%.2f,%s" % (
+                    name, ("wait", "run")[kind], count, low * TICK_MS, high * TICK_MS,
+                    ",".join(str(h) for h in hist)))
+    elif cmd == "energy":
+        if args and args[0] == "reset":
+            machine.command("z")
+            return
+        print("state,active_ms,lpm0_ms,lpm3_ms,energy_uj")
+        for state in sorted(STATES):
+            active, lpm0, lpm3, energy = machine.command("w %d" % state)[1:]
+            print("%s,%.0f,%.0f,%.0f,%d" % (
+                STATES[state], active * TICK_MS, lpm0 * TICK_MS, lpm3 * TICK_MS, energy))
+        pills, energy, per_pill = machine.command("w")
+        print("# objects=%d energy_uj=%d uj_per_object=%d" % (pills, energy, per_pill))
+    elif cmd == "bench":
+        ram, *cycles = machine.command("r")
+        print("ramfunc=%d" % ram)
+        for name, value in zip(("getEvent", "timer_stamp", "TCS_scale_rgb", "I2C_read_reg"),
+                               cycles):
+            print("%-15s %d cycles" % (name, value))
+    elif cmd == "sweep":
+        objects = int(args[4]) if len(args) > 4 else 10
+        sweep(machine, field_index(args[0]), int(args[1]), int(args[2]), int(args[3]), objects)
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main(sys.argv)